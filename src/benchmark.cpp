@@ -0,0 +1,173 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <stdlib.h>
+#include <algorithm>
+
+#include "maze.h"
+#include "mazesolver.h"
+#include "fixedmaze.h"
+#include "dynamicmazesolver.h"
+
+static const int DEFAULT_ITERATIONS = 20000;
+
+/**
+ * Returns the average time in microseconds to generate and solve a runtime-sized maze
+ * @param width - maze width
+ * @param height - maze height
+ * @param algorithm - maze generation algorithm to use
+ * @param iterations - number of mazes to generate
+ * @param checksum - incremented by solution lengths so the work can't be optimized away
+*/
+static double benchmarkMaze(int width, int height, Maze::Algorithm algorithm, int iterations, long & checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        Maze maze(width, height, false, algorithm, i);
+        MazeSolver solver(maze);
+        checksum += solver.getSolution().size();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Returns the average time in microseconds to generate and solve a fixed-size maze
+ * @param iterations - number of mazes to generate
+ * @param checksum - incremented by solution lengths so the work can't be optimized away
+*/
+template <int Width, int Height, class Generator>
+static double benchmarkFixedMaze(int iterations, long & checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        FixedMaze<Width, Height, Generator> maze(i);
+        checksum += maze.getSolution().count();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Returns the average time in microseconds to generate a runtime-sized maze
+ * @param width - maze width
+ * @param height - maze height
+ * @param algorithm - maze generation algorithm to use
+ * @param iterations - number of mazes to generate
+ * @param checksum - incremented by a cell value so the work can't be optimized away
+*/
+static double benchmarkGeneration(int width, int height, Maze::Algorithm algorithm, int iterations, long & checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        Maze maze(width, height, false, algorithm, i);
+        checksum += maze.getCell(0, 0).right_path;
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+/**
+ * Applies random wall edits to a maze, querying the solution after each one, and prints the average time per 
+ * edit when the solution is maintained by DynamicMazeSolver and when MazeSolver is re-run
+ * @param width - maze width
+ * @param height - maze height
+ * @param edits - number of edits
+*/
+static void benchmarkEdits(int width, int height, int edits) {
+    // same mazes and edits for both: toggle a random right or down wall
+    Maze dynamicMaze(width, height, false, Maze::DFS, 1);
+    Maze rebuiltMaze(width, height, false, Maze::DFS, 1);
+    DynamicMazeSolver dynamicSolver(dynamicMaze);
+    std::mt19937 rng(1);
+    std::vector<std::tuple<int, int, Maze::Direction>> editList;
+    for (int i = 0; i < edits; i++) {
+        editList.push_back(std::make_tuple(rng() % width, rng() % height, rng() % 2 ? Maze::Right : Maze::Down));
+    }
+
+    long dynamicSolvable = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto & edit : editList) {
+        int x = std::get<0>(edit);
+        int y = std::get<1>(edit);
+        Maze::Direction direction = std::get<2>(edit);
+        if (!dynamicSolver.openWall(x, y, direction)) dynamicSolver.closeWall(x, y, direction);
+        dynamicSolvable += dynamicSolver.isSolvable();
+    }
+    std::chrono::duration<double, std::micro> dynamicTime = std::chrono::steady_clock::now() - start;
+
+    long rebuiltSolvable = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto & edit : editList) {
+        int x = std::get<0>(edit);
+        int y = std::get<1>(edit);
+        Maze::Direction direction = std::get<2>(edit);
+        if (!rebuiltMaze.openWall(x, y, direction)) rebuiltMaze.closeWall(x, y, direction);
+        MazeSolver solver(rebuiltMaze);
+        rebuiltSolvable += !solver.getSolution().empty();
+    }
+    std::chrono::duration<double, std::micro> rebuiltTime = std::chrono::steady_clock::now() - start;
+
+    std::string name = std::to_string(width) + "x" + std::to_string(height);
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << rebuiltTime.count() / edits << std::setw(14) << dynamicTime.count() / edits
+              << std::setw(10) << rebuiltTime.count() / dynamicTime.count() << "x"
+              << (dynamicSolvable == rebuiltSolvable ? "" : "  (solvability differs!)") << "\n";
+}
+
+/**
+ * Prints one row of benchmark results
+ * @param name - algorithm and maze size
+ * @param runtimeSized - average time per maze for Maze
+ * @param fixedSize - average time per maze for FixedMaze
+*/
+static void printResult(std::string name, double runtimeSized, double fixedSize) {
+    std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(14) << runtimeSized << std::setw(14) << fixedSize
+              << std::setw(10) << runtimeSized / fixedSize << "x\n";
+}
+
+/**
+ * Benchmarks maze generation and solving. Usage: maisy_bench [iterations]
+*/
+int main(int argc, char * argv[]) {
+    int iterations = argc > 1 ? atoi(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations <= 0) iterations = DEFAULT_ITERATIONS;
+    long checksum = 0;
+
+    std::cout << "Generate + solve, average microseconds per maze over " << iterations << " mazes\n";
+    std::cout << std::left << std::setw(20) << "maze" << std::right << std::setw(14) << "Maze"
+              << std::setw(14) << "FixedMaze" << std::setw(11) << "speedup" << "\n";
+    printResult("DFS 16x16", benchmarkMaze(16, 16, Maze::DFS, iterations, checksum),
+                benchmarkFixedMaze<16, 16, FixedDFSGenerator>(iterations, checksum));
+    printResult("DFS 32x32", benchmarkMaze(32, 32, Maze::DFS, iterations, checksum),
+                benchmarkFixedMaze<32, 32, FixedDFSGenerator>(iterations, checksum));
+    printResult("Kruskal 16x16", benchmarkMaze(16, 16, Maze::Kruskal, iterations, checksum),
+                benchmarkFixedMaze<16, 16, FixedKruskalGenerator>(iterations, checksum));
+    printResult("Kruskal 32x32", benchmarkMaze(32, 32, Maze::Kruskal, iterations, checksum),
+                benchmarkFixedMaze<32, 32, FixedKruskalGenerator>(iterations, checksum));
+
+    const int largeIterations = std::max(1, iterations / 50);
+    std::cout << "\nMaze generation only, average microseconds per maze (" << iterations << " small, " 
+              << largeIterations << " large mazes)\n";
+    std::cout << std::left << std::setw(20) << "algorithm" << std::right << std::setw(14) << "32x32"
+              << std::setw(14) << "100x100" << "\n";
+    const Maze::Algorithm algorithms[] = { Maze::DFS, Maze::Kruskal, Maze::HuntAndKill, Maze::GrowingTreeNewest,
+                                           Maze::GrowingTreeRandom, Maze::GrowingTreeMixed };
+    const std::string names[] = { "DFS", "Kruskal", "Hunt-and-kill", "Growing tree newest", "Growing tree random",
+                                  "Growing tree mixed" };
+    for (int i = 0; i < 6; i++) {
+        std::cout << std::left << std::setw(20) << names[i] << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << benchmarkGeneration(32, 32, algorithms[i], iterations, checksum)
+                  << std::setw(14) << benchmarkGeneration(100, 100, algorithms[i], largeIterations, checksum) << "\n";
+    }
+
+    std::cout << "\nRandom wall edit + solvability query, average microseconds per edit (" << iterations 
+              << " edits at 32x32, fewer on larger mazes)\n";
+    std::cout << std::left << std::setw(20) << "maze" << std::right << std::setw(14) << "MazeSolver"
+              << std::setw(14) << "Dynamic" << std::setw(11) << "speedup" << "\n";
+    benchmarkEdits(32, 32, iterations);
+    benchmarkEdits(100, 100, std::max(1, iterations / 10));
+    // MazeSolver recurses once per cell on its search path, so much larger DFS mazes overflow the default stack
+    benchmarkEdits(300, 300, std::max(1, iterations / 20));
+    std::cout << "(checksum " << checksum << ")\n";
+    return 0;
+}
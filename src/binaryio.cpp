@@ -0,0 +1,50 @@
+#include "binaryio.h"
+
+/**
+ * Writes a 32 bit unsigned integer to stream in little endian byte order
+ * @param out - stream to write to
+ * @param value - value to write
+*/
+void writeUint32(std::ostream & out, uint32_t value) {
+    char bytes[4];
+    for (int i = 0; i < 4; i++) {
+        bytes[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+    out.write(bytes, 4);
+}
+
+/**
+ * Reads a 32 bit unsigned integer written by writeUint32. Returns false if stream ended.
+ * @param in - stream to read from
+ * @param value - value read
+*/
+bool readUint32(std::istream & in, uint32_t & value) {
+    uint8_t bytes[4];
+    if (!in.read(reinterpret_cast<char*>(bytes), 4)) return false;
+    value = readLittleEndian(bytes, 4);
+    return true;
+}
+
+/**
+ * Appends a 32 bit unsigned integer to buffer in little endian byte order
+ * @param buffer - buffer to append to
+ * @param value - value to append
+*/
+void appendUint32(std::vector<uint8_t> & buffer, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<uint8_t>((value >> (8 * i)) & 0xff));
+    }
+}
+
+/**
+ * Reads a little endian unsigned integer of size bytes
+ * @param bytes - bytes to read from
+ * @param size - number of bytes, at most 4
+*/
+uint32_t readLittleEndian(const uint8_t * bytes, int size) {
+    uint32_t value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return value;
+}
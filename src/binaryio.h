@@ -0,0 +1,36 @@
+#ifndef BINARYIO_H_
+#define BINARYIO_H_
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Writes a 32 bit unsigned integer to stream in little endian byte order
+ * @param out - stream to write to
+ * @param value - value to write
+*/
+void writeUint32(std::ostream & out, uint32_t value);
+
+/**
+ * Reads a 32 bit unsigned integer written by writeUint32. Returns false if stream ended.
+ * @param in - stream to read from
+ * @param value - value read
+*/
+bool readUint32(std::istream & in, uint32_t & value);
+
+/**
+ * Appends a 32 bit unsigned integer to buffer in little endian byte order
+ * @param buffer - buffer to append to
+ * @param value - value to append
+*/
+void appendUint32(std::vector<uint8_t> & buffer, uint32_t value);
+
+/**
+ * Reads a little endian unsigned integer of size bytes
+ * @param bytes - bytes to read from
+ * @param size - number of bytes, at most 4
+*/
+uint32_t readLittleEndian(const uint8_t * bytes, int size);
+
+#endif
@@ -11,6 +11,13 @@
 #define BOLD    "\033[1m"
 #define UNDERLINE "\033[4m"
 
+static const std::string SAVE_FILE_HEADER = "maisy-save";
+static const int REPLAY_FRAME_TIME = 50000; // microseconds
+static const int FRAME_TIME = 16667; // microseconds, 60 frames per second
+static const int ANIMATION_FRAME_TIME = 30000; // microseconds
+static const int MAX_ANIMATION_FRAMES = 600; // longest animation is about 20 seconds
+static const char GOAL_REACHED = '\x01'; // not bound to any key, and distinct from 0 (no action yet)
+
 /**
  * Constructor to create a console game. Initializes player coordinates to (0,0).
 */
@@ -33,26 +40,103 @@ void ConsoleGame::getInput() {
     char input;
     do {
         if (maze == nullptr) createMaze();
-        system("clear");
-        printCenteredTitle("Maze Generator 3000", maze->getWidth());
-        if (displaySolution) {
-            maze->printMaze(x, y, &solution);
-        } else {
-            maze->printMaze(x, y);
-        }
-        if (x == maze->getWidth() - 1 && y == maze->getHeight() -1) {
+        input = runGameLoop();
+        if (input == GOAL_REACHED) {
             endGame();
             return;
         }
-        std::cout << BLUE << "\nEnter W/A/S/D to move, Z to toggle solution display, M to generate new maze (Q to quit): " << RESET;
-        std::cin >> input;
-        input = toupper(input);
         if (input != 'Q') {
             respondToInput(input, maze->getCell(x,y));
         }
     } while (input != 'Q');
 }
 
+/**
+ * Runs the game at a fixed frame rate with raw terminal input until the player reaches the goal or presses
+ * a key that needs line input (M, V, L) or quits (Q). Moves are applied as soon as keys arrive and all
+ * input received within a frame is drawn in a single update. Returns the key pressed, or GOAL_REACHED.
+*/
+char ConsoleGame::runGameLoop() {
+    RawTerminal terminal;
+    bool fullRedraw = true;
+    int prevX = x;
+    int prevY = y;
+    char action = 0;
+    std::string pendingKeys; // incomplete escape sequence carried over to the next frame
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (true) {
+        std::string keys = pendingKeys + terminal.readKeys();
+        pendingKeys.clear();
+        for (size_t i = 0; i < keys.size() && !action; i++) {
+            char key = toupper(keys[i]);
+            // an escape sequence may be split across reads, wait for the rest of it
+            if (key == '\033' && (i + 1 == keys.size() || (i + 2 == keys.size() && keys[i + 1] == '['))) {
+                pendingKeys = keys.substr(i);
+                break;
+            }
+            // arrow keys arrive as the escape sequences ESC [ A (up), B (down), C (right), D (left)
+            if (key == '\033' && i + 2 < keys.size() && keys[i + 1] == '[') {
+                const std::string arrows = "ABCD";
+                const std::string moves = "WSDA";
+                size_t arrow = arrows.find(keys[i + 2]);
+                key = arrow != std::string::npos ? moves[arrow] : 0;
+                i += 2;
+            }
+            if (key == 'Q' || key == 'M' || key == 'V' || key == 'L') {
+                action = key;
+            } else {
+                if (key == 'Z') fullRedraw = true;
+                respondToInput(key, maze->getCell(x, y));
+                if (x == maze->getWidth() - 1 && y == maze->getHeight() - 1) action = GOAL_REACHED;
+            }
+        }
+        // also catches starting on the goal, e.g. a 1x1 maze or a loaded game that ended there
+        if (!action && x == maze->getWidth() - 1 && y == maze->getHeight() - 1) action = GOAL_REACHED;
+        if (!action && terminal.isClosed()) action = 'Q';
+
+        renderFrame(fullRedraw, prevX, prevY);
+        fullRedraw = false;
+        prevX = x;
+        prevY = y;
+        if (action) {
+            // leave the cursor below the maze and prompt for any line input that follows
+            std::cout << "\033[" << maze->getHeight() + 5 << ";1H" << std::flush;
+            return action;
+        }
+
+        nextFrame += std::chrono::microseconds(FRAME_TIME);
+        auto now = std::chrono::steady_clock::now();
+        if (nextFrame < now) {
+            nextFrame = now; // fell behind, don't try to catch up
+        } else {
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+}
+
+/**
+ * Draws the current game state
+ * @param fullRedraw - redraw the whole screen, otherwise only the cells at the previous and current positions
+ * @param prevX - player x coordinate when last drawn
+ * @param prevY - player y coordinate when last drawn
+*/
+void ConsoleGame::renderFrame(bool fullRedraw, int prevX, int prevY) {
+    const std::set<int> * positions = displaySolution ? &solution : nullptr;
+    if (fullRedraw) {
+        std::cout << "\033[H\033[2J";
+        printCenteredTitle("Maze Generator 3000", maze->getWidth());
+        maze->printMaze(x, y, positions);
+        std::cout << BLUE << "\nW/A/S/D or arrow keys to move, Z to toggle solution display, M to generate new maze, "
+                  << "V to save, L to load (Q to quit)" << RESET;
+    } else if (prevX != x || prevY != y) {
+        moveCursorToCell(prevX, prevY);
+        maze->printCellMarker(prevX, prevY, false, positions);
+        moveCursorToCell(x, y);
+        maze->printCellMarker(x, y, true, positions);
+    }
+    std::cout << std::flush;
+}
+
 /**
  * Responds to player input
  * @param input - player input
@@ -61,24 +145,40 @@ void ConsoleGame::getInput() {
 void ConsoleGame::respondToInput(char input, Maze::Cell cell) {
     switch (input) {
         case 'W':
-            if (cell.up_path) y--;
-            recordCurrentPosition();
+            move(Maze::Up, cell.up_path);
             break;
         case 'A':
-            if (cell.left_path) x--;
-            recordCurrentPosition();
+            move(Maze::Left, cell.left_path);
             break;
         case 'S':
-            if (cell.down_path) y++;
-            recordCurrentPosition();
+            move(Maze::Down, cell.down_path);
             break;
         case 'D':
-            if (cell.right_path) x++;
-            recordCurrentPosition();
+            move(Maze::Right, cell.right_path);
             break;
         case 'M':
             createMaze();
             break;
+        case 'V': {
+            std::string filename;
+            std::cout << "Save file name: ";
+            std::cin >> filename;
+            if (!saveGame(filename)) {
+                std::cout << RED << "Could not save to " << filename << RESET << std::endl;
+                usleep(1000000);
+            }
+            break;
+        }
+        case 'L': {
+            std::string filename;
+            std::cout << "Load file name: ";
+            std::cin >> filename;
+            if (!loadGame(filename)) {
+                std::cout << RED << "Could not load " << filename << RESET << std::endl;
+                usleep(1000000);
+            }
+            break;
+        }
         case 'Z':
             displaySolution = !displaySolution;
             break;
@@ -109,10 +209,16 @@ void ConsoleGame::createMaze() {
     char input;
 
     Maze::Algorithm algorithm = Maze::DFS;
-    std::cout << "Algorithms:\n\tD - Depth First Search \n\tK - Kruskal's Algorithm \nMaze Generation Algorithm to Use: ";
+    std::cout << "Algorithms:\n\tD - Depth First Search \n\tK - Kruskal's Algorithm \n\tH - Hunt-and-Kill "
+              << "\n\tN - Growing Tree (newest cell) \n\tR - Growing Tree (random cell) \n\tG - Growing Tree (mixed) "
+              << "\nMaze Generation Algorithm to Use: ";
     std::cin >> input;
     input = toupper(input);
     if (input == 'K') algorithm = Maze::Kruskal;
+    if (input == 'H') algorithm = Maze::HuntAndKill;
+    if (input == 'N') algorithm = Maze::GrowingTreeNewest;
+    if (input == 'R') algorithm = Maze::GrowingTreeRandom;
+    if (input == 'G') algorithm = Maze::GrowingTreeMixed;
 
     bool animate = false;
     std::cout << "Show animation of maze generation? (Y/N): ";
@@ -121,15 +227,44 @@ void ConsoleGame::createMaze() {
     if (input == 'Y') animate = true;
 
     maze = std::make_unique<Maze>(width, height, animate, algorithm);
+    if (animate) animateGeneration();
     x = 0;
     y = 0;
-    positions.clear();
-    recordCurrentPosition();
+    moveLog.clear(x, y);
     MazeSolver solver(*maze);
     solution = solver.getSolution();
     displaySolution = false;
 }
 
+/**
+ * Runs generation of the current maze to completion, printing it at a fixed frame rate. Many steps are batched into
+ * each frame for large mazes, and the batch grows if frames take longer than the frame time to print.
+*/
+void ConsoleGame::animateGeneration() {
+    const std::string titles[] = { "depth first search starting at maze center", "Kruskal's Algorithm", 
+                                   "hunt-and-kill starting at maze center", "growing tree starting at maze center" };
+    std::string title = "Maze Generation : " + titles[std::min<int>(maze->getAlgorithm(), Maze::GrowingTreeNewest)];
+    const auto frameTime = std::chrono::microseconds(ANIMATION_FRAME_TIME);
+    // most algorithms take about two steps per cell
+    int stepsPerFrame = std::max(1, 2 * maze->getWidth() * maze->getHeight() / MAX_ANIMATION_FRAMES);
+    std::cout << "\033[2J";
+    bool isComplete = false;
+    while (!isComplete) {
+        auto frameStart = std::chrono::steady_clock::now();
+        isComplete = maze->generateSteps(stepsPerFrame);
+        // overwrite the previous frame in place rather than clearing the screen
+        std::cout << "\033[H" << title << "\n";
+        maze->printMaze();
+        std::cout << std::flush;
+        auto frameEnd = frameStart + frameTime;
+        if (std::chrono::steady_clock::now() > frameEnd) {
+            stepsPerFrame *= 2; // printing can't keep up, skip frames
+        } else {
+            std::this_thread::sleep_until(frameEnd);
+        }
+    }
+}
+
 /**
  * Gets an integer from console. Displays error message and reprompts user if integer not entered properly.
  * @param message - message to display prompting user for input
@@ -154,16 +289,14 @@ int ConsoleGame::getIntegerFromConsole(std::string message) {
  * Responds to user reaching target
 */
 void ConsoleGame::endGame() {
-    for (const auto& position : positions) {
-        system("clear");
-        printCenteredTitle("Maze Generator 3000", maze->getWidth());
-        if (displaySolution) {
-            maze->printMaze(std::get<0>(position), std::get<1>(position), &solution);
-        } else {
-            maze->printMaze(std::get<0>(position), std::get<1>(position));
-        }
+    std::cout << BOLD << MAGENTA << "\nCONGRATULATIONS!!!" << RESET << std::endl;
+    int speed = getIntegerFromConsole("Replay speed (1-9, 0 to skip replay): ");
+    if (speed > 0) {
+        // each speed level doubles the number of moves shown per frame
+        int fromMove = getIntegerFromConsole("Replay from move (0-" + std::to_string(moveLog.size()) + "): ");
+        fromMove = std::max(0, std::min(fromMove, moveLog.size()));
+        replay(fromMove, 1 << (std::min(speed, 9) - 1));
         std::cout << BOLD << MAGENTA << "\nCONGRATULATIONS!!!" << RESET << std::endl;
-        usleep(50000);
     }
     std::cout << "Generate new maze? (Y/N): ";
     char input;
@@ -176,8 +309,109 @@ void ConsoleGame::endGame() {
 }
 
 /**
- * Records current x and y position in maze
+ * Moves player one cell in direction if there is a path and the move log has room, and records the move
+ * @param direction - direction to move
+ * @param hasPath - whether there is a path from the current cell in direction
+*/
+void ConsoleGame::move(Maze::Direction direction, bool hasPath) {
+    // the player stays put once the log is full, so saves and replays always match the position
+    if (!hasPath || !moveLog.record(direction)) return;
+    MoveLog::step(direction, x, y);
+}
+
+/**
+ * Replays the recorded moves, redrawing only the cells that change between frames
+ * @param fromMove - number of moves to skip before the replay starts
+ * @param movesPerFrame - number of moves to advance per frame
+*/
+void ConsoleGame::replay(int fromMove, int movesPerFrame) {
+    const std::set<int> * positions = displaySolution ? &solution : nullptr;
+    int posX, posY;
+    std::tie(posX, posY) = moveLog.getPosition(fromMove);
+
+    system("clear");
+    printCenteredTitle("Maze Generator 3000", maze->getWidth());
+    maze->printMaze(posX, posY, positions);
+    std::cout << std::flush;
+
+    int move = fromMove;
+    while (move < moveLog.size()) {
+        usleep(REPLAY_FRAME_TIME);
+        // restore previous cell, then mark the cell reached at the end of this frame
+        moveCursorToCell(posX, posY);
+        maze->printCellMarker(posX, posY, false, positions);
+        for (int i = 0; i < movesPerFrame && move < moveLog.size(); i++, move++) {
+            MoveLog::step(moveLog.getMove(move), posX, posY);
+        }
+        moveCursorToCell(posX, posY);
+        maze->printCellMarker(posX, posY, true, positions);
+        std::cout << std::flush;
+    }
+    // move cursor below maze
+    std::cout << "\033[" << maze->getHeight() + 3 << ";1H";
+}
+
+/**
+ * Moves the terminal cursor onto a cell's marker character. Assumes the title and maze were printed from the
+ * top of a cleared screen.
+ * @param cellX - x coordinate of the cell
+ * @param cellY - y coordinate of the cell
+*/
+void ConsoleGame::moveCursorToCell(int cellX, int cellY) {
+    // title and top border occupy the first two lines; each cell is 3 characters wide after the left border
+    std::cout << "\033[" << cellY + 3 << ";" << cellX * Maze::GRID_SIZE + 3 << "H";
+}
+
+/**
+ * Saves maze seed and move log to a file. Returns false if file could not be written.
+ * @param filename - file to save to
+*/
+bool ConsoleGame::saveGame(std::string filename) {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) return false;
+    out << SAVE_FILE_HEADER << " " << maze->getWidth() << " " << maze->getHeight() << " " 
+        << maze->getAlgorithm() << " " << maze->getSeed() << "\n";
+    return moveLog.save(out);
+}
+
+/**
+ * Loads a game saved by saveGame, regenerating the maze from its seed and moving the player to the last
+ * recorded position. Returns false if the file could not be read or does not match its maze.
+ * @param filename - file to load from
 */
-void ConsoleGame::recordCurrentPosition() {
-    positions.push_back(std::make_tuple(x, y));
-}
\ No newline at end of file
+bool ConsoleGame::loadGame(std::string filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::string header;
+    int width, height, algorithm;
+    unsigned int seed;
+    if (!(in >> header >> width >> height >> algorithm >> seed) || header != SAVE_FILE_HEADER || 
+        width <= 0 || height <= 0 || algorithm < 0 || algorithm > Maze::GrowingTreeMixed || in.get() != '\n') {
+        return false;
+    }
+    MoveLog loadedLog;
+    if (!loadedLog.load(in)) return false;
+
+    auto loadedMaze = std::make_unique<Maze>(width, height, false, static_cast<Maze::Algorithm>(algorithm), seed);
+    // check every move follows a path in the regenerated maze
+    int posX, posY;
+    std::tie(posX, posY) = loadedLog.getPosition(0);
+    for (int i = 0; i < loadedLog.size(); i++) {
+        if (posX < 0 || posX >= width || posY < 0 || posY >= height) return false;
+        Maze::Cell cell = loadedMaze->getCell(posX, posY);
+        Maze::Direction direction = loadedLog.getMove(i);
+        if ((direction == Maze::Up && !cell.up_path) || (direction == Maze::Down && !cell.down_path) ||
+            (direction == Maze::Left && !cell.left_path) || (direction == Maze::Right && !cell.right_path)) {
+            return false;
+        }
+        MoveLog::step(direction, posX, posY);
+    }
+    if (posX < 0 || posX >= width || posY < 0 || posY >= height) return false;
+
+    maze = std::move(loadedMaze);
+    moveLog = loadedLog;
+    std::tie(x, y) = moveLog.getPosition(moveLog.size());
+    MazeSolver solver(*maze);
+    solution = solver.getSolution();
+    displaySolution = false;
+    return true;
+}
@@ -9,9 +9,14 @@
 #include <tuple> 
 #include <unistd.h>
 #include <set>
+#include <fstream>
+#include <chrono>
+#include <thread>
 
 #include "maze.h"
 #include "mazesolver.h"
+#include "movelog.h"
+#include "terminal.h"
 
 
 class ConsoleGame { 
@@ -35,10 +40,25 @@ class ConsoleGame {
         int x;
         int y;
         std::unique_ptr<Maze> maze;
-        std::vector<std::tuple<int, int>> positions; // All positions player has visited
+        MoveLog moveLog; // All moves player has made
         std::set<int> solution; // positions in maze solution
         bool displaySolution;
 
+        /**
+         * Runs the game at a fixed frame rate with raw terminal input until the player reaches the goal or presses
+         * a key that needs line input (M, V, L) or quits (Q). Moves are applied as soon as keys arrive and all
+         * input received within a frame is drawn in a single update. Returns the key pressed, or GOAL_REACHED.
+        */
+        char runGameLoop();
+
+        /**
+         * Draws the current game state
+         * @param fullRedraw - redraw the whole screen, otherwise only the cells at the previous and current positions
+         * @param prevX - player x coordinate when last drawn
+         * @param prevY - player y coordinate when last drawn
+        */
+        void renderFrame(bool fullRedraw, int prevX, int prevY);
+
         /**
          * Responds to player input
          * @param input - player input
@@ -58,6 +78,13 @@ class ConsoleGame {
         */
         void createMaze();
 
+        /**
+         * Runs generation of the current maze to completion, printing it at a fixed frame rate. Many steps are 
+         * batched into each frame for large mazes, and the batch grows if frames take longer than the frame time 
+         * to print.
+        */
+        void animateGeneration();
+
         /**
          * Gets an integer from console. Displays error message and reprompts user if integer not entered properly.
          * @param message - message to display prompting user for input
@@ -70,9 +97,39 @@ class ConsoleGame {
         void endGame();
 
         /**
-         * Records current x and y position in maze
+         * Moves player one cell in direction if there is a path and the move log has room, and records the move
+         * @param direction - direction to move
+         * @param hasPath - whether there is a path from the current cell in direction
+        */
+        void move(Maze::Direction direction, bool hasPath);
+
+        /**
+         * Replays the recorded moves, redrawing only the cells that change between frames
+         * @param fromMove - number of moves to skip before the replay starts
+         * @param movesPerFrame - number of moves to advance per frame
+        */
+        void replay(int fromMove, int movesPerFrame);
+
+        /**
+         * Moves the terminal cursor onto a cell's marker character. Assumes the title and maze were printed from the
+         * top of a cleared screen.
+         * @param cellX - x coordinate of the cell
+         * @param cellY - y coordinate of the cell
+        */
+        void moveCursorToCell(int cellX, int cellY);
+
+        /**
+         * Saves maze seed and move log to a file. Returns false if file could not be written.
+         * @param filename - file to save to
+        */
+        bool saveGame(std::string filename);
+
+        /**
+         * Loads a game saved by saveGame, regenerating the maze from its seed and moving the player to the last
+         * recorded position. Returns false if the file could not be read or does not match its maze.
+         * @param filename - file to load from
         */
-        void recordCurrentPosition();
+        bool loadGame(std::string filename);
 
 
 };
@@ -0,0 +1,416 @@
+#include "dynamicconnectivity.h"
+
+/**
+ * Constructor to create a graph of n vertices and no edges
+ * @param n - number of vertices
+*/
+DynamicConnectivity::DynamicConnectivity(int n)
+    : vertexCount(n),
+      levels(1),
+      rng(1)
+{
+    // an edge's level never exceeds log2(n), since a level i tree has at most n / 2^i vertices
+    while ((1LL << levels) <= n) levels++;
+    edgeNodes.resize(levels);
+    nonForestEdges.resize(levels);
+
+    // node 0 is the null sentinel, with no nodes, vertices or flags below it
+    left.push_back(0);
+    right.push_back(0);
+    parent.push_back(0);
+    priority.push_back(0);
+    size.push_back(0);
+    vertices.push_back(0);
+    ownFlags.push_back(0);
+    flags.push_back(0);
+    from.push_back(-1);
+    to.push_back(-1);
+    vertexNodes.reserve(static_cast<size_t>(levels) * n);
+    for (int level = 0; level < levels; level++) {
+        for (int v = 0; v < n; v++) {
+            vertexNodes.push_back(createNode(v, v));
+        }
+    }
+}
+
+/**
+ * Adds the edge (u, v), which must not already be in the graph. Returns true if the edge joined two trees
+ * and was added to the spanning forest, false if it closes a cycle.
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+bool DynamicConnectivity::addEdge(int u, int v) {
+    if (u > v) std::swap(u, v);
+    if (connected(u, v)) {
+        edges[getKey(u, v)] = { 0, false };
+        addNonForestEdge(0, u, v);
+        return false;
+    }
+    edges[getKey(u, v)] = { 0, true };
+    addForestEdge(0, u, v);
+    return true;
+}
+
+/**
+ * Removes the edge (u, v), which must be in the graph. Returns true if it was a forest edge and another
+ * edge was found to reconnect the two trees; the replacement is added to the spanning forest.
+ * @param u - first vertex
+ * @param v - second vertex
+ * @param replacement - set to the replacement edge, if one was found
+*/
+bool DynamicConnectivity::removeEdge(int u, int v, std::pair<int, int> & replacement) {
+    if (u > v) std::swap(u, v);
+    auto found = edges.find(getKey(u, v));
+    Edge edge = found->second;
+    edges.erase(found);
+    if (!edge.isForestEdge) {
+        removeNonForestEdge(edge.level, u, v);
+        return false;
+    }
+    for (int level = 0; level <= edge.level; level++) {
+        cut(level, u, v);
+    }
+    return findReplacement(edge.level, u, v, replacement);
+}
+
+/**
+ * Returns true if (u, v) is an edge of the spanning forest
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+bool DynamicConnectivity::isForestEdge(int u, int v) {
+    auto found = edges.find(getKey(std::min(u, v), std::max(u, v)));
+    return found != edges.end() && found->second.isForestEdge;
+}
+
+/**
+ * Returns true if there is a path between u and v
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+bool DynamicConnectivity::connected(int u, int v) {
+    return getRoot(getVertexNode(0, u)) == getRoot(getVertexNode(0, v));
+}
+
+/**
+ * Returns the key of the edge or direction (u, v)
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+uint64_t DynamicConnectivity::getKey(int u, int v) {
+    return static_cast<uint64_t>(u) * vertexCount + v;
+}
+
+/**
+ * Returns the node of vertex v in a level's forest
+ * @param level - forest level
+ * @param v - vertex
+*/
+int DynamicConnectivity::getVertexNode(int level, int v) {
+    return vertexNodes[static_cast<size_t>(level) * vertexCount + v];
+}
+
+/**
+ * Creates a treap node for a vertex (from == to) or one direction of an edge
+ * @param nodeFrom - first vertex
+ * @param nodeTo - second vertex
+*/
+int DynamicConnectivity::createNode(int nodeFrom, int nodeTo) {
+    int x;
+    if (!freeNodes.empty()) {
+        x = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        x = left.size();
+        left.push_back(0);
+        right.push_back(0);
+        parent.push_back(0);
+        priority.push_back(0);
+        size.push_back(0);
+        vertices.push_back(0);
+        ownFlags.push_back(0);
+        flags.push_back(0);
+        from.push_back(0);
+        to.push_back(0);
+    }
+    left[x] = right[x] = parent[x] = 0;
+    priority[x] = static_cast<uint32_t>(rng());
+    ownFlags[x] = 0;
+    from[x] = nodeFrom;
+    to[x] = nodeTo;
+    update(x);
+    return x;
+}
+
+/**
+ * Recomputes x's subtree size, vertex count and flags from its children
+ * @param x - node
+*/
+void DynamicConnectivity::update(int x) {
+    size[x] = 1 + size[left[x]] + size[right[x]];
+    vertices[x] = (from[x] == to[x]) + vertices[left[x]] + vertices[right[x]];
+    flags[x] = ownFlags[x] | flags[left[x]] | flags[right[x]];
+}
+
+/**
+ * Sets or clears one of x's own flags and updates the subtrees containing it
+ * @param x - node
+ * @param flag - NodeFlag to change
+ * @param isSet - new value of the flag
+*/
+void DynamicConnectivity::setFlag(int x, NodeFlag flag, bool isSet) {
+    if (isSet) {
+        ownFlags[x] |= flag;
+    } else {
+        ownFlags[x] &= ~flag;
+    }
+    for (; x != 0; x = parent[x]) {
+        update(x);
+    }
+}
+
+/**
+ * Concatenates two treaps and returns the root of the result
+ * @param a - root of the first treap
+ * @param b - root of the second treap
+*/
+int DynamicConnectivity::merge(int a, int b) {
+    if (a == 0) return b;
+    if (b == 0) return a;
+    if (priority[a] > priority[b]) {
+        right[a] = merge(right[a], b);
+        parent[right[a]] = a;
+        update(a);
+        return a;
+    }
+    left[b] = merge(a, left[b]);
+    parent[left[b]] = b;
+    update(b);
+    return b;
+}
+
+/**
+ * Splits a treap into its first count nodes and the rest
+ * @param t - root of the treap
+ * @param count - number of nodes in the first part
+ * @param first - set to the root of the first part
+ * @param rest - set to the root of the rest
+*/
+void DynamicConnectivity::split(int t, int count, int & first, int & rest) {
+    splitSubtree(t, count, first, rest);
+    parent[first] = 0;
+    parent[rest] = 0;
+    parent[0] = 0; // in case either part was empty
+}
+
+/**
+ * Recursive part of split, leaves the parents of the returned roots unset
+ * @param t - root of the subtree
+ * @param count - number of nodes in the first part
+ * @param first - set to the root of the first part
+ * @param rest - set to the root of the rest
+*/
+void DynamicConnectivity::splitSubtree(int t, int count, int & first, int & rest) {
+    if (t == 0) {
+        first = rest = 0;
+        return;
+    }
+    int part;
+    if (size[left[t]] >= count) {
+        splitSubtree(left[t], count, first, part);
+        left[t] = part;
+        parent[part] = t;
+        rest = t;
+    } else {
+        splitSubtree(right[t], count - size[left[t]] - 1, part, rest);
+        right[t] = part;
+        parent[part] = t;
+        first = t;
+    }
+    parent[0] = 0;
+    update(t);
+}
+
+/**
+ * Returns the root of the treap containing x, which identifies x's tree in its forest
+ * @param x - node
+*/
+int DynamicConnectivity::getRoot(int x) {
+    while (parent[x] != 0) x = parent[x];
+    return x;
+}
+
+/**
+ * Returns the position of x in its Euler tour
+ * @param x - node
+*/
+int DynamicConnectivity::getIndex(int x) {
+    int index = size[left[x]];
+    for (; parent[x] != 0; x = parent[x]) {
+        if (right[parent[x]] == x) index += size[left[parent[x]]] + 1;
+    }
+    return index;
+}
+
+/**
+ * Rotates x's Euler tour to start at x, making x's vertex the root of its tree. Returns the treap root.
+ * @param x - vertex node
+*/
+int DynamicConnectivity::reroot(int x) {
+    int before, after;
+    split(getRoot(x), getIndex(x), before, after);
+    return merge(after, before);
+}
+
+/**
+ * Returns a node in the treap rooted at root with flag set, or 0 if there is none
+ * @param root - treap root
+ * @param flag - NodeFlag to find
+*/
+int DynamicConnectivity::findFlagged(int root, NodeFlag flag) {
+    if (!(flags[root] & flag)) return 0;
+    int x = root;
+    while (!(ownFlags[x] & flag)) {
+        x = (flags[left[x]] & flag) ? left[x] : right[x];
+    }
+    return x;
+}
+
+/**
+ * Joins the trees of u and v in a level's forest with the edge (u, v)
+ * @param level - forest level
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+void DynamicConnectivity::link(int level, int u, int v) {
+    int tourU = reroot(getVertexNode(level, u));
+    int tourV = reroot(getVertexNode(level, v));
+    int forward = createNode(u, v);
+    int backward = createNode(v, u);
+    edgeNodes[level][getKey(u, v)] = forward;
+    edgeNodes[level][getKey(v, u)] = backward;
+    // the tour of u, across to v, the tour of v, and back to u
+    merge(merge(merge(tourU, forward), tourV), backward);
+}
+
+/**
+ * Removes the edge (u, v) from a level's forest
+ * @param level - forest level
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+void DynamicConnectivity::cut(int level, int u, int v) {
+    auto forward = edgeNodes[level].find(getKey(u, v));
+    auto backward = edgeNodes[level].find(getKey(v, u));
+    int first = forward->second;
+    int second = backward->second;
+    edgeNodes[level].erase(forward);
+    edgeNodes[level].erase(backward);
+    if (getIndex(first) > getIndex(second)) std::swap(first, second);
+
+    // the tour is A first B second C; B is the tour of one tree, and A C of the other
+    int start = getIndex(first);
+    int end = getIndex(second);
+    int before, middle, after, edgeNode;
+    split(getRoot(first), end, middle, after);
+    split(after, 1, edgeNode, after);
+    split(middle, start, before, middle);
+    split(middle, 1, edgeNode, middle);
+    merge(before, after);
+    freeNodes.push_back(first);
+    freeNodes.push_back(second);
+}
+
+/**
+ * Adds (u, v) to the forest at levels 0 to level, with level as its own level
+ * @param level - edge level
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+void DynamicConnectivity::addForestEdge(int level, int u, int v) {
+    for (int i = 0; i <= level; i++) {
+        link(i, u, v);
+    }
+    setFlag(edgeNodes[level][getKey(u, v)], FOREST_EDGE, true);
+}
+
+/**
+ * Records (u, v) as a non-forest edge of level
+ * @param level - edge level
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+void DynamicConnectivity::addNonForestEdge(int level, int u, int v) {
+    nonForestEdges[level][u].insert(v);
+    nonForestEdges[level][v].insert(u);
+    setFlag(getVertexNode(level, u), NON_FOREST_EDGES, true);
+    setFlag(getVertexNode(level, v), NON_FOREST_EDGES, true);
+}
+
+/**
+ * Removes the non-forest edge (u, v) of level
+ * @param level - edge level
+ * @param u - first vertex
+ * @param v - second vertex
+*/
+void DynamicConnectivity::removeNonForestEdge(int level, int u, int v) {
+    // remove v from u's neighbors, then u from v's
+    const int ends[] = { u, v, v, u };
+    for (int i = 0; i < 4; i += 2) {
+        auto found = nonForestEdges[level].find(ends[i]);
+        found->second.erase(ends[i + 1]);
+        if (found->second.empty()) {
+            nonForestEdges[level].erase(found);
+            setFlag(getVertexNode(level, ends[i]), NON_FOREST_EDGES, false);
+        }
+    }
+}
+
+/**
+ * Searches for an edge reconnecting the trees of u and v after a forest edge of level between them was cut.
+ * Returns true and adds the edge to the forest if one was found.
+ * @param level - level of the cut edge
+ * @param u - first vertex of the cut edge
+ * @param v - second vertex of the cut edge
+ * @param replacement - set to the replacement edge, if one was found
+*/
+bool DynamicConnectivity::findReplacement(int level, int u, int v, std::pair<int, int> & replacement) {
+    for (; level >= 0; level--) {
+        int rootU = getRoot(getVertexNode(level, u));
+        int rootV = getRoot(getVertexNode(level, v));
+        int smaller = vertices[rootU] <= vertices[rootV] ? rootU : rootV;
+        // nothing to search at this level, so nothing to pay for by moving edges up (common in perfect mazes,
+        // which have no non-forest edges at all)
+        if (!(flags[smaller] & NON_FOREST_EDGES)) continue;
+
+        // the smaller tree has at most half the vertices, so it fits one level up; moving its edges there
+        // pays for searching them
+        int x;
+        while ((x = findFlagged(smaller, FOREST_EDGE)) != 0) {
+            int a = std::min(from[x], to[x]);
+            int b = std::max(from[x], to[x]);
+            setFlag(x, FOREST_EDGE, false);
+            edges[getKey(a, b)].level = level + 1;
+            link(level + 1, a, b);
+            setFlag(edgeNodes[level + 1][getKey(a, b)], FOREST_EDGE, true);
+        }
+
+        // every non-forest edge of this level leaving the smaller tree is a replacement; the rest have both
+        // ends in the smaller tree and move up a level
+        while ((x = findFlagged(smaller, NON_FOREST_EDGES)) != 0) {
+            int a = from[x];
+            int b = *nonForestEdges[level][a].begin();
+            removeNonForestEdge(level, a, b);
+            Edge & edge = edges[getKey(std::min(a, b), std::max(a, b))];
+            if (getRoot(getVertexNode(level, b)) != smaller) {
+                edge.isForestEdge = true;
+                addForestEdge(level, std::min(a, b), std::max(a, b));
+                replacement = std::make_pair(std::min(a, b), std::max(a, b));
+                return true;
+            }
+            edge.level = level + 1;
+            addNonForestEdge(level + 1, a, b);
+        }
+    }
+    return false;
+}
@@ -0,0 +1,236 @@
+#ifndef DYNAMICCONNECTIVITY_H_
+#define DYNAMICCONNECTIVITY_H_
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <random>
+#include <utility>
+#include <stdint.h>
+
+/**
+ * Fully dynamic connectivity of an undirected graph on n vertices (Holm, de Lichtenberg and Thorup). A spanning
+ * forest of the graph is maintained under edge insertions and deletions; when a forest edge is deleted, the
+ * remaining edges are searched for a replacement that reconnects the two trees.
+ *
+ * Every edge has a level, starting at 0 and only increasing, of at most log2(n). Level i's forest holds the forest
+ * edges of level >= i, and each of its trees has at most n / 2^i vertices. A deletion searches the smaller of the
+ * two trees left at each level from the deleted edge's level down, raising the level of every edge it searches
+ * and fails to use, so each edge is searched O(log n) times over its lifetime. Each level's forest is stored as
+ * Euler tours in treaps, giving O(log^2 n) amortized time per insertion or deletion and O(log n) per
+ * connectivity query.
+*/
+class DynamicConnectivity {
+    public:
+        /**
+         * Constructor to create a graph of n vertices and no edges
+         * @param n - number of vertices
+        */
+        DynamicConnectivity(int n);
+
+        /**
+         * Adds the edge (u, v), which must not already be in the graph. Returns true if the edge joined two trees
+         * and was added to the spanning forest, false if it closes a cycle.
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        bool addEdge(int u, int v);
+
+        /**
+         * Removes the edge (u, v), which must be in the graph. Returns true if it was a forest edge and another
+         * edge was found to reconnect the two trees; the replacement is added to the spanning forest.
+         * @param u - first vertex
+         * @param v - second vertex
+         * @param replacement - set to the replacement edge, if one was found
+        */
+        bool removeEdge(int u, int v, std::pair<int, int> & replacement);
+
+        /**
+         * Returns true if (u, v) is an edge of the spanning forest
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        bool isForestEdge(int u, int v);
+
+        /**
+         * Returns true if there is a path between u and v
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        bool connected(int u, int v);
+
+    private:
+        // Flags kept on treap nodes and aggregated over subtrees, so a tree's flagged nodes are found by descent
+        enum NodeFlag {
+            FOREST_EDGE = 1, // edge node of a forest edge whose level is the forest's level
+            NON_FOREST_EDGES = 2 // vertex node of a vertex with non-forest edges at the forest's level
+        };
+
+        // Level and kind of each edge in the graph
+        struct Edge {
+            int level;
+            bool isForestEdge;
+        };
+
+        int vertexCount;
+        int levels;
+        std::unordered_map<uint64_t, Edge> edges; // keyed by getKey(smaller vertex, larger vertex)
+
+        // Treap nodes are stored as parallel arrays; node 0 is a null sentinel. An Euler tour holds one node per
+        // vertex (from == to) and two per forest edge, one for each direction (from != to).
+        std::vector<int> left;
+        std::vector<int> right;
+        std::vector<int> parent;
+        std::vector<uint32_t> priority;
+        std::vector<int> size; // number of nodes in the subtree
+        std::vector<int> vertices; // number of vertex nodes in the subtree
+        std::vector<uint8_t> ownFlags;
+        std::vector<uint8_t> flags; // OR of ownFlags over the subtree
+        std::vector<int> from;
+        std::vector<int> to;
+        std::vector<int> freeNodes; // edge nodes available for reuse
+        std::mt19937 rng;
+
+        std::vector<int> vertexNodes; // node of vertex v in level i's forest is vertexNodes[i * vertexCount + v]
+        std::vector<std::unordered_map<uint64_t, int>> edgeNodes; // per level, getKey(from, to) -> node
+        // per level, vertex -> other ends of its non-forest edges of that level
+        std::vector<std::unordered_map<int, std::unordered_set<int>>> nonForestEdges;
+
+        /**
+         * Returns the key of the edge or direction (u, v)
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        uint64_t getKey(int u, int v);
+
+        /**
+         * Returns the node of vertex v in a level's forest
+         * @param level - forest level
+         * @param v - vertex
+        */
+        int getVertexNode(int level, int v);
+
+        /**
+         * Creates a treap node for a vertex (from == to) or one direction of an edge
+         * @param nodeFrom - first vertex
+         * @param nodeTo - second vertex
+        */
+        int createNode(int nodeFrom, int nodeTo);
+
+        /**
+         * Recomputes x's subtree size, vertex count and flags from its children
+         * @param x - node
+        */
+        void update(int x);
+
+        /**
+         * Sets or clears one of x's own flags and updates the subtrees containing it
+         * @param x - node
+         * @param flag - NodeFlag to change
+         * @param isSet - new value of the flag
+        */
+        void setFlag(int x, NodeFlag flag, bool isSet);
+
+        /**
+         * Concatenates two treaps and returns the root of the result
+         * @param a - root of the first treap
+         * @param b - root of the second treap
+        */
+        int merge(int a, int b);
+
+        /**
+         * Splits a treap into its first count nodes and the rest
+         * @param t - root of the treap
+         * @param count - number of nodes in the first part
+         * @param first - set to the root of the first part
+         * @param rest - set to the root of the rest
+        */
+        void split(int t, int count, int & first, int & rest);
+
+        /**
+         * Recursive part of split, leaves the parents of the returned roots unset
+         * @param t - root of the subtree
+         * @param count - number of nodes in the first part
+         * @param first - set to the root of the first part
+         * @param rest - set to the root of the rest
+        */
+        void splitSubtree(int t, int count, int & first, int & rest);
+
+        /**
+         * Returns the root of the treap containing x, which identifies x's tree in its forest
+         * @param x - node
+        */
+        int getRoot(int x);
+
+        /**
+         * Returns the position of x in its Euler tour
+         * @param x - node
+        */
+        int getIndex(int x);
+
+        /**
+         * Rotates x's Euler tour to start at x, making x's vertex the root of its tree. Returns the treap root.
+         * @param x - vertex node
+        */
+        int reroot(int x);
+
+        /**
+         * Returns a node in the treap rooted at root with flag set, or 0 if there is none
+         * @param root - treap root
+         * @param flag - NodeFlag to find
+        */
+        int findFlagged(int root, NodeFlag flag);
+
+        /**
+         * Joins the trees of u and v in a level's forest with the edge (u, v)
+         * @param level - forest level
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        void link(int level, int u, int v);
+
+        /**
+         * Removes the edge (u, v) from a level's forest
+         * @param level - forest level
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        void cut(int level, int u, int v);
+
+        /**
+         * Adds (u, v) to the forest at levels 0 to level, with level as its own level
+         * @param level - edge level
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        void addForestEdge(int level, int u, int v);
+
+        /**
+         * Records (u, v) as a non-forest edge of level
+         * @param level - edge level
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        void addNonForestEdge(int level, int u, int v);
+
+        /**
+         * Removes the non-forest edge (u, v) of level
+         * @param level - edge level
+         * @param u - first vertex
+         * @param v - second vertex
+        */
+        void removeNonForestEdge(int level, int u, int v);
+
+        /**
+         * Searches for an edge reconnecting the trees of u and v after a forest edge of level between them was cut.
+         * Returns true and adds the edge to the forest if one was found.
+         * @param level - level of the cut edge
+         * @param u - first vertex of the cut edge
+         * @param v - second vertex of the cut edge
+         * @param replacement - set to the replacement edge, if one was found
+        */
+        bool findReplacement(int level, int u, int v, std::pair<int, int> & replacement);
+
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "dynamicmazesolver.h"
+
+/**
+ * Constructor to create a solver for a maze. Edits must be made through this solver, not the maze directly.
+ * @param maze - the maze to be solved
+*/
+DynamicMazeSolver::DynamicMazeSolver(Maze & maze)
+    : maze(maze),
+      goal(maze.getWidth() * maze.getHeight() - 1),
+      connectivity(maze.getWidth() * maze.getHeight()),
+      forest(maze.getWidth() * maze.getHeight())
+{
+    for (int y = 0; y < maze.getHeight(); y++) {
+        for (int x = 0; x < maze.getWidth(); x++) {
+            Maze::Cell cell = maze.getCell(x, y);
+            if (cell.right_path) addEdge(getEdge(x, y, Maze::Right));
+            if (cell.down_path) addEdge(getEdge(x, y, Maze::Down));
+        }
+    }
+}
+
+/**
+ * Opens the wall between a cell and its neighbor in direction and updates the solution. Returns false if 
+ * the cell has no neighbor in direction or there is already a path.
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param direction - direction of the neighbor
+*/
+bool DynamicMazeSolver::openWall(int x, int y, Maze::Direction direction) {
+    if (!maze.openWall(x, y, direction)) return false;
+    addEdge(getEdge(x, y, direction));
+    return true;
+}
+
+/**
+ * Closes the path between a cell and its neighbor in direction and updates the solution. Returns false if 
+ * the cell has no neighbor in direction or there is already a wall.
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param direction - direction of the neighbor
+*/
+bool DynamicMazeSolver::closeWall(int x, int y, Maze::Direction direction) {
+    if (!maze.closeWall(x, y, direction)) return false;
+    auto edge = getEdge(x, y, direction);
+    bool wasForestEdge = connectivity.isForestEdge(std::get<0>(edge), std::get<1>(edge));
+    std::pair<int, int> replacement;
+    bool isReplaced = connectivity.removeEdge(std::get<0>(edge), std::get<1>(edge), replacement);
+    if (wasForestEdge) {
+        forest.cut(std::get<0>(edge), std::get<1>(edge));
+        if (isReplaced) forest.link(replacement.first, replacement.second);
+    }
+    return true;
+}
+
+/**
+ * Returns true if there is a path from (0,0) to the goal
+*/
+bool DynamicMazeSolver::isSolvable() {
+    return forest.connected(0, goal);
+}
+
+/**
+ * Returns the number of cells in the solution, or 0 if the maze can't be solved
+*/
+int DynamicMazeSolver::getSolutionLength() {
+    return isSolvable() ? forest.pathSize(0, goal) : 0;
+}
+
+/**
+ * Returns the cells (getCellInteger) of the solution in order from (0,0) to the goal, or an empty list if 
+ * the maze can't be solved
+*/
+std::vector<int> DynamicMazeSolver::getSolutionPath() {
+    if (!isSolvable()) return std::vector<int>();
+    return forest.path(0, goal);
+}
+
+/**
+ * Returns a set containing the integer representation of all cells that are part of the maze solution
+*/
+std::set<int> DynamicMazeSolver::getSolution() {
+    std::vector<int> path = getSolutionPath();
+    return std::set<int>(path.begin(), path.end());
+}
+
+/**
+ * Returns the path between a cell and its neighbor in direction as (smaller cell, larger cell)
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param direction - direction of the neighbor
+*/
+std::tuple<int, int> DynamicMazeSolver::getEdge(int x, int y, Maze::Direction direction) {
+    int cell = y * maze.getWidth() + x;
+    if (direction == Maze::Up) return std::make_tuple(cell - maze.getWidth(), cell);
+    if (direction == Maze::Down) return std::make_tuple(cell, cell + maze.getWidth());
+    if (direction == Maze::Left) return std::make_tuple(cell - 1, cell);
+    return std::make_tuple(cell, cell + 1);
+}
+
+/**
+ * Adds a path to the graph, and to the forest if it joins two trees
+ * @param edge - the path, as (smaller cell, larger cell)
+*/
+void DynamicMazeSolver::addEdge(std::tuple<int, int> edge) {
+    if (connectivity.addEdge(std::get<0>(edge), std::get<1>(edge))) {
+        forest.link(std::get<0>(edge), std::get<1>(edge));
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef DYNAMICMAZESOLVER_H_
+#define DYNAMICMAZESOLVER_H_
+
+#include <set>
+#include <vector>
+#include <tuple>
+#include <utility>
+
+#include "maze.h"
+#include "linkcuttree.h"
+#include "dynamicconnectivity.h"
+
+/**
+ * Maintains a maze's start-to-goal solution while its walls are edited. Paths between cells form a graph whose 
+ * spanning forest is maintained by DynamicConnectivity, which finds a replacement path when a forest path is 
+ * closed. The same forest is kept in a link-cut tree, and the solution is its path from (0,0) to the goal.
+ *
+ * Opening or closing a wall takes O(log^2 n) amortized time for n cells, however many loops the maze has. 
+ * Solvability and solution length queries take O(log n) amortized time.
+*/
+class DynamicMazeSolver { 
+    public:
+        /**
+         * Constructor to create a solver for a maze. Edits must be made through this solver, not the maze directly.
+         * @param maze - the maze to be solved
+        */
+        DynamicMazeSolver(Maze & maze);
+
+        /**
+         * Opens the wall between a cell and its neighbor in direction and updates the solution. Returns false if 
+         * the cell has no neighbor in direction or there is already a path.
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param direction - direction of the neighbor
+        */
+        bool openWall(int x, int y, Maze::Direction direction);
+
+        /**
+         * Closes the path between a cell and its neighbor in direction and updates the solution. Returns false if 
+         * the cell has no neighbor in direction or there is already a wall.
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param direction - direction of the neighbor
+        */
+        bool closeWall(int x, int y, Maze::Direction direction);
+
+        /**
+         * Returns true if there is a path from (0,0) to the goal
+        */
+        bool isSolvable();
+
+        /**
+         * Returns the number of cells in the solution, or 0 if the maze can't be solved
+        */
+        int getSolutionLength();
+
+        /**
+         * Returns the cells (getCellInteger) of the solution in order from (0,0) to the goal, or an empty list if 
+         * the maze can't be solved
+        */
+        std::vector<int> getSolutionPath();
+
+        /**
+         * Returns a set containing the integer representation of all cells that are part of the maze solution
+        */
+        std::set<int> getSolution();
+
+    private:
+        Maze & maze;
+        int goal;
+        DynamicConnectivity connectivity; // all paths, and which of them form the spanning forest
+        LinkCutTree forest; // the spanning forest's paths, for solution queries
+
+        /**
+         * Returns the path between a cell and its neighbor in direction as (smaller cell, larger cell)
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param direction - direction of the neighbor
+        */
+        std::tuple<int, int> getEdge(int x, int y, Maze::Direction direction);
+
+        /**
+         * Adds a path to the graph, and to the forest if it joins two trees
+         * @param edge - the path, as (smaller cell, larger cell)
+        */
+        void addEdge(std::tuple<int, int> edge);
+
+};
+
+#endif
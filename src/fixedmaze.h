@@ -0,0 +1,278 @@
+#ifndef FIXEDMAZE_H_
+#define FIXEDMAZE_H_
+
+#include <array>
+#include <bitset>
+#include <random>
+#include <algorithm>
+#include <stdint.h>
+
+#include "maze.h"
+
+static const Maze::Direction FIXED_MAZE_DIRECTIONS[] = { Maze::Left, Maze::Right, Maze::Up, Maze::Down };
+
+/**
+ * Generation policy for FixedMaze; depth-first search starting at the maze center, using an explicit stack
+*/
+struct FixedDFSGenerator {
+    template <class FixedMazeType>
+    static void generate(FixedMazeType & maze) {
+        std::array<int, FixedMazeType::CELLS> stack;
+        std::bitset<FixedMazeType::CELLS> visited;
+        int top = 0;
+        int start = FixedMazeType::getCellInteger(FixedMazeType::getWidth() / 2, FixedMazeType::getHeight() / 2);
+        stack[top++] = start;
+        visited[start] = true;
+        while (top > 0) {
+            int cell = stack[top - 1];
+            Maze::Direction unvisitedNeighbors[4];
+            int count = 0;
+            for (Maze::Direction direction : FIXED_MAZE_DIRECTIONS) {
+                if (FixedMazeType::hasNeighbor(cell, direction) && 
+                    !visited[FixedMazeType::getNeighbor(cell, direction)]) {
+                    unvisitedNeighbors[count++] = direction;
+                }
+            }
+            if (count == 0) {
+                top--;
+                continue;
+            }
+            Maze::Direction direction = unvisitedNeighbors[std::uniform_int_distribution<int>(0, count - 1)(maze.getRng())];
+            int next = FixedMazeType::getNeighbor(cell, direction);
+            maze.removeWall(cell, direction);
+            visited[next] = true;
+            stack[top++] = next;
+        }
+    }
+};
+
+/**
+ * Generation policy for FixedMaze; Kruskal's algorithm over a shuffled list of walls, using a fixed size 
+ * disjoint set with path halving and union by size
+*/
+struct FixedKruskalGenerator {
+    template <class FixedMazeType>
+    static void generate(FixedMazeType & maze) {
+        // wall stored as cell * 2, plus 1 for a down wall (otherwise a right wall)
+        std::array<int, 2 * FixedMazeType::CELLS> walls;
+        int wallCount = 0;
+        for (int cell = 0; cell < FixedMazeType::CELLS; cell++) {
+            if (FixedMazeType::hasNeighbor(cell, Maze::Right)) walls[wallCount++] = cell * 2;
+            if (FixedMazeType::hasNeighbor(cell, Maze::Down)) walls[wallCount++] = cell * 2 + 1;
+        }
+        std::shuffle(walls.begin(), walls.begin() + wallCount, maze.getRng());
+
+        std::array<int, FixedMazeType::CELLS> parent;
+        parent.fill(-1);
+        auto find = [&parent](int x) {
+            while (parent[x] >= 0) {
+                if (parent[parent[x]] >= 0) parent[x] = parent[parent[x]];
+                x = parent[x];
+            }
+            return x;
+        };
+        for (int i = 0; i < wallCount; i++) {
+            int cell = walls[i] / 2;
+            Maze::Direction direction = walls[i] % 2 ? Maze::Down : Maze::Right;
+            int rootA = find(cell);
+            int rootB = find(FixedMazeType::getNeighbor(cell, direction));
+            if (rootA == rootB) continue;
+            maze.removeWall(cell, direction);
+            if (parent[rootA] < parent[rootB]) std::swap(rootA, rootB); // rootB has more elements
+            parent[rootB] += parent[rootA];
+            parent[rootA] = rootB;
+        }
+    }
+};
+
+/**
+ * Solving policy for FixedMaze; depth-first search from the top left to the bottom right cell, using an 
+ * explicit stack
+*/
+struct FixedDFSSolver {
+    template <class FixedMazeType>
+    static std::bitset<FixedMazeType::CELLS> solve(const FixedMazeType & maze) {
+        std::array<int, FixedMazeType::CELLS> parent;
+        std::array<int, FixedMazeType::CELLS> stack;
+        std::bitset<FixedMazeType::CELLS> visited;
+        const int goal = FixedMazeType::CELLS - 1;
+        int top = 0;
+        stack[top++] = 0;
+        visited[0] = true;
+        parent[0] = -1;
+        while (top > 0) {
+            int cell = stack[--top];
+            if (cell == goal) break;
+            for (Maze::Direction direction : FIXED_MAZE_DIRECTIONS) {
+                if (!maze.hasPath(cell, direction)) continue;
+                int next = FixedMazeType::getNeighbor(cell, direction);
+                if (visited[next]) continue;
+                visited[next] = true;
+                parent[next] = cell;
+                stack[top++] = next;
+            }
+        }
+
+        std::bitset<FixedMazeType::CELLS> solution;
+        if (!visited[goal]) return solution;
+        for (int cell = goal; cell != -1; cell = parent[cell]) {
+            solution[cell] = true;
+        }
+        return solution;
+    }
+};
+
+/**
+ * Maze whose dimensions are compile-time constants. All cells are stored inline (on the stack for a local 
+ * FixedMaze), and the generation and solving algorithms are policy types, so neighbour checks against the 
+ * maze bounds fold to constants and the generator and solver inline into the constructor. Intended for 
+ * generating large numbers of small mazes; use Maze for runtime-sized, animated or playable mazes.
+ * @tparam Width - number of cells in maze width
+ * @tparam Height - number of cells in maze height
+ * @tparam Generator - generation policy, FixedDFSGenerator or FixedKruskalGenerator
+ * @tparam Solver - solving policy, FixedDFSSolver
+*/
+template <int Width, int Height, class Generator = FixedDFSGenerator, class Solver = FixedDFSSolver>
+class FixedMaze { 
+    static_assert(Width > 0 && Height > 0, "maze must have at least one cell");
+    static_assert(Width * Height <= 65536, "FixedMaze is intended for small mazes");
+
+    public:
+        static const int CELLS = Width * Height;
+
+        /**
+         * Constructor to create a random maze and find its solution
+         * @param seed - seed for the random number generator
+        */
+        explicit FixedMaze(unsigned int seed = std::random_device{}())
+            : rng(seed)
+        {
+            paths.fill(0);
+            Generator::generate(*this);
+            solution = Solver::solve(*this);
+        }
+
+        /**
+         * Returns a cell from the maze. isVisited is always false.
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+        */
+        Maze::Cell getCell(int x, int y) const {
+            Maze::Cell cell;
+            uint8_t cellPaths = paths[getCellInteger(x, y)];
+            cell.x = x;
+            cell.y = y;
+            cell.left_path = cellPaths & pathBit(Maze::Left);
+            cell.right_path = cellPaths & pathBit(Maze::Right);
+            cell.up_path = cellPaths & pathBit(Maze::Up);
+            cell.down_path = cellPaths & pathBit(Maze::Down);
+            return cell;
+        }
+
+        /**
+         * Returns maze width
+        */
+        static constexpr int getWidth() {
+            return Width;
+        }
+
+        /**
+         * Returns maze height
+        */
+        static constexpr int getHeight() {
+            return Height;
+        }
+
+        /**
+         * Returns int representing cell's location in maze grid
+         * @param x - cell's x coordinate in maze
+         * @param y - cell's y coordinate in maze
+        */
+        static constexpr int getCellInteger(int x, int y) {
+            return (y * Width) + x;
+        }
+
+        /**
+         * Returns the set of cells (by getCellInteger) that are part of the maze solution
+        */
+        const std::bitset<CELLS> & getSolution() const {
+            return solution;
+        }
+
+        /**
+         * Returns true if the cell has a neighbor in direction
+         * @param cell - cell number (getCellInteger)
+         * @param direction - direction of neighbor
+        */
+        static constexpr bool hasNeighbor(int cell, Maze::Direction direction) {
+            return direction == Maze::Left ? cell % Width != 0 :
+                   direction == Maze::Right ? cell % Width != Width - 1 :
+                   direction == Maze::Up ? cell >= Width :
+                   cell < CELLS - Width;
+        }
+
+        /**
+         * Returns the neighboring cell in direction. Only valid if hasNeighbor(cell, direction).
+         * @param cell - cell number (getCellInteger)
+         * @param direction - direction of neighbor
+        */
+        static constexpr int getNeighbor(int cell, Maze::Direction direction) {
+            return direction == Maze::Left ? cell - 1 :
+                   direction == Maze::Right ? cell + 1 :
+                   direction == Maze::Up ? cell - Width :
+                   cell + Width;
+        }
+
+        /**
+         * Returns true if there is no wall between the cell and its neighbor in direction
+         * @param cell - cell number (getCellInteger)
+         * @param direction - direction of neighbor
+        */
+        bool hasPath(int cell, Maze::Direction direction) const {
+            return paths[cell] & pathBit(direction);
+        }
+
+        /**
+         * Removes the wall between the cell and its neighbor in direction. Only valid if hasNeighbor(cell, direction).
+         * @param cell - cell number (getCellInteger)
+         * @param direction - direction of neighbor
+        */
+        void removeWall(int cell, Maze::Direction direction) {
+            paths[cell] |= pathBit(direction);
+            paths[getNeighbor(cell, direction)] |= pathBit(opposite(direction));
+        }
+
+        /**
+         * Returns the random number generator used for generation
+        */
+        std::mt19937 & getRng() {
+            return rng;
+        }
+
+    private:
+        std::array<uint8_t, CELLS> paths; // one bit per direction with a passage
+        std::bitset<CELLS> solution;
+        std::mt19937 rng;
+
+        /**
+         * Returns the bit in paths representing a passage in direction
+         * @param direction - direction of passage
+        */
+        static constexpr uint8_t pathBit(Maze::Direction direction) {
+            return static_cast<uint8_t>(1 << direction);
+        }
+
+        /**
+         * Returns the opposite direction
+         * @param direction - direction to reverse
+        */
+        static constexpr Maze::Direction opposite(Maze::Direction direction) {
+            return direction == Maze::Up ? Maze::Down :
+                   direction == Maze::Down ? Maze::Up :
+                   direction == Maze::Left ? Maze::Right :
+                   Maze::Left;
+        }
+
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "linkcuttree.h"
+
+/**
+ * Constructor to create a forest of n unconnected nodes
+ * @param n - number of nodes
+*/
+LinkCutTree::LinkCutTree(int n)
+    : left(n, -1),
+      right(n, -1),
+      parent(n, -1),
+      flipped(n, false),
+      size(n, 1)
+{}
+
+/**
+ * Adds the edge (u, v). u and v must be in different trees.
+ * @param u - first node
+ * @param v - second node
+*/
+void LinkCutTree::link(int u, int v) {
+    makeRoot(u);
+    parent[u] = v;
+}
+
+/**
+ * Removes the edge (u, v). The edge must be in the forest.
+ * @param u - first node
+ * @param v - second node
+*/
+void LinkCutTree::cut(int u, int v) {
+    makeRoot(u);
+    access(v);
+    // the path is exactly u, v, so u is v's left child
+    parent[left[v]] = -1;
+    left[v] = -1;
+    update(v);
+}
+
+/**
+ * Returns true if u and v are in the same tree
+ * @param u - first node
+ * @param v - second node
+*/
+bool LinkCutTree::connected(int u, int v) {
+    return u == v || findRoot(u) == findRoot(v);
+}
+
+/**
+ * Returns the number of nodes on the tree path from u to v. u and v must be connected.
+ * @param u - first node
+ * @param v - second node
+*/
+int LinkCutTree::pathSize(int u, int v) {
+    makeRoot(u);
+    access(v);
+    return size[v];
+}
+
+/**
+ * Returns the nodes on the tree path from u to v, in order. u and v must be connected.
+ * @param u - first node
+ * @param v - second node
+*/
+std::vector<int> LinkCutTree::path(int u, int v) {
+    makeRoot(u);
+    access(v);
+    // in-order traversal of v's splay tree
+    std::vector<int> nodes;
+    nodes.reserve(size[v]);
+    std::vector<int> stack;
+    int x = v;
+    while (x != -1 || !stack.empty()) {
+        while (x != -1) {
+            push(x);
+            stack.push_back(x);
+            x = left[x];
+        }
+        x = stack.back();
+        stack.pop_back();
+        nodes.push_back(x);
+        x = right[x];
+    }
+    return nodes;
+}
+
+/**
+ * Returns true if x is the root of its splay tree
+ * @param x - node
+*/
+bool LinkCutTree::isSplayRoot(int x) {
+    int p = parent[x];
+    return p == -1 || (left[p] != x && right[p] != x);
+}
+
+/**
+ * Applies x's pending reversal to its children
+ * @param x - node
+*/
+void LinkCutTree::push(int x) {
+    if (!flipped[x]) return;
+    std::swap(left[x], right[x]);
+    if (left[x] != -1) flipped[left[x]] = !flipped[left[x]];
+    if (right[x] != -1) flipped[right[x]] = !flipped[right[x]];
+    flipped[x] = false;
+}
+
+/**
+ * Recomputes x's subtree size from its children
+ * @param x - node
+*/
+void LinkCutTree::update(int x) {
+    size[x] = 1 + (left[x] != -1 ? size[left[x]] : 0) + (right[x] != -1 ? size[right[x]] : 0);
+}
+
+/**
+ * Rotates x above its parent in the splay tree
+ * @param x - node
+*/
+void LinkCutTree::rotate(int x) {
+    int p = parent[x];
+    int g = parent[p];
+    if (!isSplayRoot(p)) {
+        if (left[g] == p) {
+            left[g] = x;
+        } else {
+            right[g] = x;
+        }
+    }
+    parent[x] = g;
+    if (left[p] == x) {
+        left[p] = right[x];
+        if (right[x] != -1) parent[right[x]] = p;
+        right[x] = p;
+    } else {
+        right[p] = left[x];
+        if (left[x] != -1) parent[left[x]] = p;
+        left[x] = p;
+    }
+    parent[p] = x;
+    update(p);
+    update(x);
+}
+
+/**
+ * Moves x to the root of its splay tree
+ * @param x - node
+*/
+void LinkCutTree::splay(int x) {
+    // apply pending reversals from the splay root down to x before rotating
+    splayPath.clear();
+    for (int y = x; ; y = parent[y]) {
+        splayPath.push_back(y);
+        if (isSplayRoot(y)) break;
+    }
+    for (auto it = splayPath.rbegin(); it != splayPath.rend(); ++it) {
+        push(*it);
+    }
+    while (!isSplayRoot(x)) {
+        int p = parent[x];
+        if (!isSplayRoot(p)) {
+            int g = parent[p];
+            // zig-zig rotates the parent first, zig-zag rotates x twice
+            if ((left[g] == p) == (left[p] == x)) {
+                rotate(p);
+            } else {
+                rotate(x);
+            }
+        }
+        rotate(x);
+    }
+}
+
+/**
+ * Makes the path from x's tree root to x preferred, leaving x at the root of its splay tree
+ * @param x - node
+*/
+void LinkCutTree::access(int x) {
+    int last = -1;
+    for (int y = x; y != -1; y = parent[y]) {
+        splay(y);
+        right[y] = last;
+        update(y);
+        last = y;
+    }
+    splay(x);
+}
+
+/**
+ * Makes x the root of its tree
+ * @param x - node
+*/
+void LinkCutTree::makeRoot(int x) {
+    access(x);
+    flipped[x] = !flipped[x];
+}
+
+/**
+ * Returns the root of x's tree
+ * @param x - node
+*/
+int LinkCutTree::findRoot(int x) {
+    access(x);
+    push(x);
+    while (left[x] != -1) {
+        x = left[x];
+        push(x);
+    }
+    splay(x);
+    return x;
+}
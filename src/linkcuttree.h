@@ -0,0 +1,114 @@
+#ifndef LINKCUTTREE_H_
+#define LINKCUTTREE_H_
+
+#include <vector>
+#include <utility>
+
+/**
+ * Link-cut tree over a forest of n nodes (Sleator and Tarjan). Supports linking and cutting edges, connectivity
+ * queries and path queries in O(log n) amortized time per operation.
+*/
+class LinkCutTree { 
+    public:
+        /**
+         * Constructor to create a forest of n unconnected nodes
+         * @param n - number of nodes
+        */
+        LinkCutTree(int n);
+
+        /**
+         * Adds the edge (u, v). u and v must be in different trees.
+         * @param u - first node
+         * @param v - second node
+        */
+        void link(int u, int v);
+
+        /**
+         * Removes the edge (u, v). The edge must be in the forest.
+         * @param u - first node
+         * @param v - second node
+        */
+        void cut(int u, int v);
+
+        /**
+         * Returns true if u and v are in the same tree
+         * @param u - first node
+         * @param v - second node
+        */
+        bool connected(int u, int v);
+
+        /**
+         * Returns the number of nodes on the tree path from u to v. u and v must be connected.
+         * @param u - first node
+         * @param v - second node
+        */
+        int pathSize(int u, int v);
+
+        /**
+         * Returns the nodes on the tree path from u to v, in order. u and v must be connected.
+         * @param u - first node
+         * @param v - second node
+        */
+        std::vector<int> path(int u, int v);
+
+    private:
+        // Nodes are stored as parallel arrays. Each preferred path is a splay tree ordered by depth; the parent of
+        // a splay tree's root is the path-parent, the node above the path in the represented tree.
+        std::vector<int> left;
+        std::vector<int> right;
+        std::vector<int> parent;
+        std::vector<bool> flipped; // children of the subtree should be swapped (lazy path reversal)
+        std::vector<int> size; // number of nodes in the splay subtree
+        std::vector<int> splayPath; // reused by splay to avoid allocating
+
+        /**
+         * Returns true if x is the root of its splay tree
+         * @param x - node
+        */
+        bool isSplayRoot(int x);
+
+        /**
+         * Applies x's pending reversal to its children
+         * @param x - node
+        */
+        void push(int x);
+
+        /**
+         * Recomputes x's subtree size from its children
+         * @param x - node
+        */
+        void update(int x);
+
+        /**
+         * Rotates x above its parent in the splay tree
+         * @param x - node
+        */
+        void rotate(int x);
+
+        /**
+         * Moves x to the root of its splay tree
+         * @param x - node
+        */
+        void splay(int x);
+
+        /**
+         * Makes the path from x's tree root to x preferred, leaving x at the root of its splay tree
+         * @param x - node
+        */
+        void access(int x);
+
+        /**
+         * Makes x the root of its tree
+         * @param x - node
+        */
+        void makeRoot(int x);
+
+        /**
+         * Returns the root of x's tree
+         * @param x - node
+        */
+        int findRoot(int x);
+
+};
+
+#endif
@@ -1,7 +1,135 @@
+#include <string>
+#include <stdlib.h>
+#include <limits.h>
+
 #include "consolegame.h"
+#include "mazeserver.h"
+#include "simulation.h"
+
+/**
+ * Prints command line usage
+*/
+static void printUsage() {
+    std::cerr << "Usage:\n"
+              << "  maisy                 play in the console\n"
+              << "  maisy --serve SOCKET [--threads N] [--cache-entries N] [--cache-dir DIR [--cache-size MB]]\n"
+              << "                       [--max-cells N]\n"
+              << "                        serve mazes over a Unix domain socket (see mazeserver.h), optionally\n"
+              << "                        keeping generated mazes in DIR\n"
+              << "  maisy --simulate [--width N] [--height N] [--algorithm D|K|H|N|R|G] [--seed N]\n"
+              << "                 [--policy random|wall|tremaux] [--agents N] [--max-steps N] [--threads N] [--heatmap]\n"
+              << "                        estimate maze difficulty by simulating many players\n";
+}
+
+/**
+ * Returns the maze generation algorithm for a letter, as used in the console game
+ * @param letter - D, K, H, N, R or G
+*/
+static Maze::Algorithm getAlgorithm(char letter) {
+    switch (toupper(letter)) {
+        case 'K':
+            return Maze::Kruskal;
+        case 'H':
+            return Maze::HuntAndKill;
+        case 'N':
+            return Maze::GrowingTreeNewest;
+        case 'R':
+            return Maze::GrowingTreeRandom;
+        case 'G':
+            return Maze::GrowingTreeMixed;
+        default:
+            return Maze::DFS;
+    }
+}
+
+int main(int argc, char * argv[]) {
+    if (argc == 1) {
+        ConsoleGame consoleGame;
+        consoleGame.getInput();
+        return 0;
+    }
+
+    std::string socketPath;
+    bool simulate = false;
+    int width = 35;
+    int height = 20;
+    Maze::Algorithm algorithm = Maze::DFS;
+    unsigned int seed = std::random_device{}();
+    Simulation::Policy policy = Simulation::RandomWalk;
+    long agents = 100000;
+    long long maxSteps = -1;
+    bool heatmap = false;
+    int threads = std::thread::hardware_concurrency();
+    int cacheEntries = 1024;
+    std::string cacheDirectory;
+    int cacheMegabytes = 256;
+    long maxCells = MazeServer::DEFAULT_MAX_CELLS;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--serve" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--simulate") {
+            simulate = true;
+        } else if (arg == "--width" && i + 1 < argc) {
+            width = atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            height = atoi(argv[++i]);
+        } else if (arg == "--algorithm" && i + 1 < argc) {
+            algorithm = getAlgorithm(argv[++i][0]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--policy" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "wall") policy = Simulation::WallFollower;
+            if (name == "tremaux") policy = Simulation::Tremaux;
+        } else if (arg == "--agents" && i + 1 < argc) {
+            agents = atol(argv[++i]);
+        } else if (arg == "--max-steps" && i + 1 < argc) {
+            maxSteps = atoll(argv[++i]);
+        } else if (arg == "--heatmap") {
+            heatmap = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (arg == "--cache-entries" && i + 1 < argc) {
+            cacheEntries = atoi(argv[++i]);
+        } else if (arg == "--cache-dir" && i + 1 < argc) {
+            cacheDirectory = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            cacheMegabytes = atoi(argv[++i]);
+        } else if (arg == "--max-cells" && i + 1 < argc) {
+            maxCells = atol(argv[++i]);
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+    if (simulate) {
+        // run takes the step limit as a uint32_t, reject larger limits rather than truncate them
+        if (width <= 0 || height <= 0 || agents <= 0 || maxSteps > UINT32_MAX) {
+            printUsage();
+            return 1;
+        }
+        Maze maze(width, height, false, algorithm, seed);
+        // default step limit is generous enough for most random walks on the maze
+        if (maxSteps <= 0) maxSteps = std::min<long long>(UINT32_MAX, 100LL * width * height);
+        Simulation simulation(maze);
+        std::cout << width << "x" << height << " maze, seed " << seed << "\n";
+        simulation.printResults(simulation.run(policy, agents, maxSteps, threads, seed), heatmap);
+        return 0;
+    }
+    if (socketPath.empty() || maxCells <= 0 || maxCells > INT_MAX) {
+        printUsage();
+        return 1;
+    }
 
-int main() {
-    ConsoleGame consoleGame;
-    consoleGame.getInput();
+    std::unique_ptr<MazeCache> diskCache;
+    if (!cacheDirectory.empty()) {
+        diskCache = std::make_unique<MazeCache>(cacheDirectory, static_cast<uint64_t>(cacheMegabytes) * 1024 * 1024);
+    }
+    MazeServer server(socketPath, threads, cacheEntries, diskCache.get(), static_cast<int>(maxCells));
+    if (!server.run()) {
+        std::cerr << "Could not listen on " << socketPath << std::endl;
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
@@ -7,16 +7,62 @@ static const int DOWN_WALL = 1;
  * Constructor to create a random maze
  * @param width - number of cells in maze width
  * @param height - number of cells in maze height
- * @param animate - show maze generation process
- * @param algorithm - maze generation algorithm to use (DFS, Kruskal)
+ * @param deferGeneration - if true, only prepare generation; the caller runs it with generateSteps, e.g. to 
+ *                          show the generation process
+ * @param algorithm - maze generation algorithm to use (DFS, Kruskal, HuntAndKill, GrowingTree*)
+ * @param seed - seed for the random number generator. Mazes created with the same size, algorithm and seed
+ *               are identical on every platform (for the same GENERATOR_VERSION). Defaults to a random seed.
 */
-Maze::Maze(int width, int height, bool animate, Algorithm algorithm)
+Maze::Maze(int width, int height, bool deferGeneration, Algorithm algorithm, unsigned int seed)
     : width(width),
       height(height),
-      animate(animate),
-      rng(std::random_device{}())
+      algorithm(algorithm),
+      seed(seed),
+      rng(seed)
 {
-    generateMaze(width, height, algorithm);
+    maze = new Cell*[width];
+    for (int i = 0; i < width; i++) {
+        maze[i] = new Cell[height];
+        for (int j = 0; j < height; j++) {
+            maze[i][j].x = i;
+            maze[i][j].y = j;
+        }
+    }
+    startGeneration();
+    if (!deferGeneration) generateSteps(std::numeric_limits<int>::max());
+}
+
+/**
+ * Constructor to create a maze from passages returned by getEncodedPaths, without generating it
+ * @param width - number of cells in maze width
+ * @param height - number of cells in maze height
+ * @param paths - passages, width * height bytes (see getEncodedPaths)
+ * @param algorithm - algorithm the maze was generated with
+ * @param seed - seed the maze was generated with
+*/
+Maze::Maze(int width, int height, const std::vector<uint8_t> & paths, Algorithm algorithm, unsigned int seed)
+    : width(width),
+      height(height),
+      algorithm(algorithm),
+      seed(seed),
+      rng(seed)
+{
+    maze = new Cell*[width];
+    for (int i = 0; i < width; i++) {
+        maze[i] = new Cell[height];
+        for (int j = 0; j < height; j++) {
+            maze[i][j].x = i;
+            maze[i][j].y = j;
+        }
+    }
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t cellPaths = paths[y * width + x];
+            if ((cellPaths & 1) && x < width - 1) removeWall(maze[x][y], maze[x + 1][y]);
+            if ((cellPaths & 2) && y < height - 1) removeWall(maze[x][y], maze[x][y + 1]);
+        }
+    }
+    generation.isComplete = true;
 }
 
 /**
@@ -33,66 +79,207 @@ Maze::~Maze() {
 }
 
 /**
- * Randomly generates a maze
- * @param width - maze width
- * @param height - maze height
- * @param algorithm - maze generation algorithm to use
+ * Sets up the generation state for this->algorithm
 */
-void Maze::generateMaze(int width, int height, Algorithm algorithm) {
-    maze = new Cell*[width];
-    for (int i = 0; i < width; i++) {
-        maze[i] = new Cell[height];
-        for (int j = 0; j < height; j++) {
-            maze[i][j].x = i;
-            maze[i][j].y = j;
-        }
+void Maze::startGeneration() {
+    generation = GenerationState();
+    Cell * center = &maze[width/2][height/2];
+    if (algorithm == DFS) {
+        center->isVisited = true;
+        generation.stack.push_back(center);
+    } else if (algorithm == Kruskal) {
+        generation.walls = getRandomizedListOfWalls();
+        generation.cellSet = DisjointSet(width*height);
+    } else if (algorithm == HuntAndKill) {
+        center->isVisited = true;
+        generation.cell = center;
+    } else {
+        if (algorithm == GrowingTreeNewest) generation.policy = Newest;
+        if (algorithm == GrowingTreeRandom) generation.policy = Random;
+        if (algorithm == GrowingTreeMixed) generation.policy = Mixed;
+        generation.activeInRow.assign(height, 0);
+        center->isVisited = true;
+        center->isActive = true;
+        generation.activeInRow[center->y]++;
+        generation.activeCount++;
+        generation.cell = center;
     }
+}
+
+/**
+ * Advances generation by up to steps steps. A step removes one wall, backtracks one cell, or (Kruskal) 
+ * rejects one wall. Returns true once generation is complete.
+ * @param steps - maximum number of steps to take
+*/
+bool Maze::generateSteps(int steps) {
+    if (generation.isComplete) return true;
+    int step = 0;
+    bool hasMoreSteps = true;
+    // dispatch once per call rather than once per step
     if (algorithm == DFS) {
-        recursivelyGenerateMaze(maze[width/2][height/2]);
+        while (step++ < steps && (hasMoreSteps = dfsStep()));
     } else if (algorithm == Kruskal) {
-        kruskalGenerateMaze();
+        while (step++ < steps && (hasMoreSteps = kruskalStep()));
+    } else if (algorithm == HuntAndKill) {
+        while (step++ < steps && (hasMoreSteps = huntAndKillStep()));
+    } else {
+        while (step++ < steps && (hasMoreSteps = growingTreeStep()));
+    }
+    if (!hasMoreSteps) {
+        generation = GenerationState(); // release generation memory
+        generation.isComplete = true;
     }
+    return generation.isComplete;
 }
 
 /**
- * Recursively generates maze using depth-first search.
- * @param cell - the starting cell for maze generation
+ * Returns true once generation is complete
 */
-void Maze::recursivelyGenerateMaze(Cell & cell) {
-    cell.isVisited = true;
-    auto unvisitedNeighbors = getUnvisitedNeighbors(cell);
-    std::uniform_int_distribution<int> dist(0, unvisitedNeighbors.size() - 1);
-    while (!unvisitedNeighbors.empty()) {
-        int next_index = dist(rng);
-        Cell * next_cell = unvisitedNeighbors[next_index];
-        removeWall(cell, *next_cell);
-        animateMaze("Maze Generation : depth first search starting at maze center");
-        recursivelyGenerateMaze(*next_cell);
-        unvisitedNeighbors = getUnvisitedNeighbors(cell);
-        dist = std::uniform_int_distribution<int>(0, unvisitedNeighbors.size() - 1);
+bool Maze::isGenerated() const {
+    return generation.isComplete;
+}
+
+/**
+ * One step of depth-first search generation, starting at maze center. Returns false if generation is complete.
+*/
+bool Maze::dfsStep() {
+    if (generation.stack.empty()) return false;
+    Cell * cell = generation.stack.back();
+    auto unvisitedNeighbors = getUnvisitedNeighbors(*cell);
+    if (unvisitedNeighbors.empty()) {
+        generation.stack.pop_back();
+        return true;
+    }
+    Cell * next_cell = unvisitedNeighbors[randomIndex(unvisitedNeighbors.size())];
+    removeWall(*cell, *next_cell);
+    next_cell->isVisited = true;
+    generation.stack.push_back(next_cell);
+    return true;
+}
+
+/**
+ * One step of Kruskal's algorithm. Returns false if generation is complete.
+*/
+bool Maze::kruskalStep() {
+    if (generation.nextWall == generation.walls.size()) return false;
+    const auto & wall = generation.walls[generation.nextWall++];
+    int cell_number = std::get<0>(wall);
+    int next_cell_number;
+    if (std::get<1>(wall) == RIGHT_WALL) {
+        next_cell_number = cell_number + 1;
+    } else {
+        next_cell_number = cell_number + width;
+    }
+    if (generation.cellSet.find(cell_number) != generation.cellSet.find(next_cell_number)) {
+        removeWall(maze[cell_number % width][cell_number / width], maze[next_cell_number % width][next_cell_number / width]);
+        generation.cellSet.setUnion(cell_number, next_cell_number);
     }
+    return true;
 }
 
 /**
- * Generates maze using Kruskal's algorithm
+ * One step of the hunt-and-kill algorithm, starting at maze center. Uses no stack; when the walk reaches a
+ * dead end, rows are scanned from the first row that still has unvisited cells for an unvisited cell next to
+ * a visited one. Returns false if generation is complete.
 */
-void Maze::kruskalGenerateMaze() {
-    auto walls = getRandomizedListOfWalls();
-    DisjointSet cell_set(width*height);
-    int cell_number,  next_cell_number;
-    for (const auto& wall : walls) {
-        cell_number = std::get<0>(wall);
-        if (std::get<1>(wall) == RIGHT_WALL) {
-            next_cell_number = cell_number + 1;
-        } else {
-            next_cell_number = cell_number + width;
+bool Maze::huntAndKillStep() {
+    Cell * cell = generation.cell;
+    if (cell == nullptr) return false;
+    auto unvisitedNeighbors = getUnvisitedNeighbors(*cell);
+    if (unvisitedNeighbors.empty()) {
+        generation.cell = huntForUnvisitedCell();
+        return generation.cell != nullptr;
+    }
+    Cell * next_cell = unvisitedNeighbors[randomIndex(unvisitedNeighbors.size())];
+    removeWall(*cell, *next_cell);
+    next_cell->isVisited = true;
+    generation.cell = next_cell;
+    return true;
+}
+
+/**
+ * Scans rows from generation.huntRow for an unvisited cell bordering a visited cell, and connects it to a 
+ * random visited neighbor. Returns the connected cell, or nullptr if every cell has been visited. 
+ * generation.huntRow is advanced past rows found to be complete.
+*/
+Maze::Cell * Maze::huntForUnvisitedCell() {
+    for (int y = generation.huntRow; y < height; y++) {
+        bool rowComplete = true;
+        for (int x = 0; x < width; x++) {
+            if (maze[x][y].isVisited) continue;
+            rowComplete = false;
+            Cell * visitedNeighbors[4];
+            int count = 0;
+            if (x > 0 && maze[x - 1][y].isVisited) visitedNeighbors[count++] = &maze[x - 1][y];
+            if (x < width - 1 && maze[x + 1][y].isVisited) visitedNeighbors[count++] = &maze[x + 1][y];
+            if (y > 0 && maze[x][y - 1].isVisited) visitedNeighbors[count++] = &maze[x][y - 1];
+            if (y < height - 1 && maze[x][y + 1].isVisited) visitedNeighbors[count++] = &maze[x][y + 1];
+            if (count > 0) {
+                removeWall(maze[x][y], *visitedNeighbors[randomIndex(count)]);
+                maze[x][y].isVisited = true;
+                return &maze[x][y];
+            }
         }
-        if (cell_set.find(cell_number) != cell_set.find(next_cell_number)) {
-            removeWall(maze[cell_number % width][cell_number / width], maze[next_cell_number % width][next_cell_number / width]);
-            cell_set.setUnion(cell_number, next_cell_number);
-            animateMaze("Maze Generation : Kruskal's Algorithm");
+        if (rowComplete && y == generation.huntRow) generation.huntRow++;
+    }
+    return nullptr;
+}
+
+/**
+ * One step of the growing tree algorithm, starting at maze center. The set of active cells is stored in the 
+ * grid (Cell::isActive) with a count of active cells per row, so only row-sized extra memory is used.
+ * Returns false if generation is complete.
+*/
+bool Maze::growingTreeStep() {
+    if (generation.activeCount == 0) return false;
+    Cell * cell = generation.cell;
+    if (cell == nullptr || generation.policy == Random || (generation.policy == Mixed && randomIndex(2) == 0)) {
+        cell = getRandomActiveCell();
+    }
+    auto unvisitedNeighbors = getUnvisitedNeighbors(*cell);
+    if (unvisitedNeighbors.empty()) {
+        cell->isActive = false;
+        generation.activeInRow[cell->y]--;
+        generation.activeCount--;
+        // The newest remaining active cell is the connected active neighbor: with the newest policy, a 
+        // finished cell's children are all finished, leaving only its parent active. With other policies this
+        // is still a valid active cell, and if there is none, a random one is chosen next step.
+        generation.cell = nullptr;
+        if (cell->left_path && maze[cell->x - 1][cell->y].isActive) {
+            generation.cell = &maze[cell->x - 1][cell->y];
+        } else if (cell->right_path && maze[cell->x + 1][cell->y].isActive) {
+            generation.cell = &maze[cell->x + 1][cell->y];
+        } else if (cell->up_path && maze[cell->x][cell->y - 1].isActive) {
+            generation.cell = &maze[cell->x][cell->y - 1];
+        } else if (cell->down_path && maze[cell->x][cell->y + 1].isActive) {
+            generation.cell = &maze[cell->x][cell->y + 1];
         }
+        return true;
     }
+    Cell * next_cell = unvisitedNeighbors[randomIndex(unvisitedNeighbors.size())];
+    removeWall(*cell, *next_cell);
+    next_cell->isVisited = true;
+    next_cell->isActive = true;
+    generation.activeInRow[next_cell->y]++;
+    generation.activeCount++;
+    generation.cell = next_cell;
+    return true;
+}
+
+/**
+ * Returns a uniformly random active cell. Used by growing tree generation; generation.activeCount must be > 0.
+*/
+Maze::Cell * Maze::getRandomActiveCell() {
+    int index = randomIndex(generation.activeCount);
+    int y = 0;
+    while (index >= generation.activeInRow[y]) {
+        index -= generation.activeInRow[y];
+        y++;
+    }
+    for (int x = 0; x < width; x++) {
+        if (maze[x][y].isActive && index-- == 0) return &maze[x][y];
+    }
+    return nullptr;
 }
 
 /**
@@ -118,6 +305,64 @@ int Maze::getHeight() {
     return height;
 }
 
+/**
+ * Opens the wall between a cell and its neighbor in direction. Returns false if the cell has no neighbor in
+ * direction or there is already a path.
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param direction - direction of the neighbor
+*/
+bool Maze::openWall(int x, int y, Direction direction) {
+    Cell * neighbor = getNeighbor(x, y, direction);
+    if (neighbor == nullptr || getPath(maze[x][y], direction)) return false;
+    removeWall(maze[x][y], *neighbor);
+    return true;
+}
+
+/**
+ * Closes the path between a cell and its neighbor in direction. Returns false if the cell has no neighbor in
+ * direction or there is already a wall.
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param direction - direction of the neighbor
+*/
+bool Maze::closeWall(int x, int y, Direction direction) {
+    Cell * neighbor = getNeighbor(x, y, direction);
+    if (neighbor == nullptr || !getPath(maze[x][y], direction)) return false;
+    getPath(maze[x][y], direction) = false;
+    const Direction opposite[] = { Down, Up, Right, Left };
+    getPath(*neighbor, opposite[direction]) = false;
+    return true;
+}
+
+/**
+ * Returns the maze's passages, one byte per cell in row-major order (getCellInteger). Bit 0 of a cell's byte
+ * is set if there is a path to the right, bit 1 if there is a path down.
+*/
+std::vector<uint8_t> Maze::getEncodedPaths() const {
+    std::vector<uint8_t> paths(width * height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            paths[y * width + x] = (maze[x][y].right_path ? 1 : 0) | (maze[x][y].down_path ? 2 : 0);
+        }
+    }
+    return paths;
+}
+
+/**
+ * Returns the algorithm used to generate the maze
+*/
+Maze::Algorithm Maze::getAlgorithm() {
+    return algorithm;
+}
+
+/**
+ * Returns the seed used to generate the maze
+*/
+unsigned int Maze::getSeed() {
+    return seed;
+}
+
 /**
  * Prints a representation of maze to console
  * @param x - optional parameter, x coordinate of point to mark on maze
@@ -138,25 +383,10 @@ void Maze::printMaze(int x, int y, const std::set<int> * positions) {
         for (int j = 0; j < width; j++) {
             if (!maze[j][i].down_path) {
                 std::cout << "_";
-                // single point on maze to print
-                if (x == j && y == i) {
-                    formattedPrint('X');
-                // positions set provided and currently on position tile
-                } else if (positions && (*positions).find(getCellInteger(j, i)) != (*positions).end()) {
-                    formattedPrint('*', "\033[36m");
-                } else {
-                    std::cout << "_";
-                }
             } else {
                 std::cout << " ";
-                if (x == j && y == i) {
-                    formattedPrint('X');
-                } else if (positions && (*positions).find(getCellInteger(j, i)) != (*positions).end()) {
-                    formattedPrint('*', "\033[36m");
-                } else {
-                    std::cout << " ";
-                }
             }
+            printCellMarker(j, i, x == j && y == i, positions);
             if (!maze[j][i].right_path) {
                 std::cout << '|';
             } else {
@@ -168,6 +398,27 @@ void Maze::printMaze(int x, int y, const std::set<int> * positions) {
     }
 }
 
+/**
+ * Prints the marker character of a single cell, the character between the cell's floor and right wall
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param isMarked - whether to mark the cell as the current point on the maze
+ * @param positions - optional parameter, set of positions to demarcate (see printMaze)
+*/
+void Maze::printCellMarker(int x, int y, bool isMarked, const std::set<int> * positions) {
+    // single point on maze to print
+    if (isMarked) {
+        formattedPrint('X');
+    // positions set provided and currently on position tile
+    } else if (positions && (*positions).find(getCellInteger(x, y)) != (*positions).end()) {
+        formattedPrint('*', "\033[36m");
+    } else if (!maze[x][y].down_path) {
+        std::cout << "_";
+    } else {
+        std::cout << " ";
+    }
+}
+
 /**
  * Returns a list of pointers to all of a cell's unvisited neighbors. The cells directly above, below, right
  * and left of a cell are considered its neighbors. A cell will be marked as visted if there is an existing
@@ -218,6 +469,33 @@ void Maze::removeWall(Cell & cellA, Cell & cellB) {
     } 
 }
 
+/**
+ * Returns the cell's neighbor in direction, or nullptr if it is on the maze edge
+ * @param x - x coordinate of the cell
+ * @param y - y coordinate of the cell
+ * @param direction - direction of the neighbor
+*/
+Maze::Cell * Maze::getNeighbor(int x, int y, Direction direction) {
+    if (x < 0 || x >= width || y < 0 || y >= height) return nullptr;
+    if (direction == Up && y > 0) return &maze[x][y - 1];
+    if (direction == Down && y < height - 1) return &maze[x][y + 1];
+    if (direction == Left && x > 0) return &maze[x - 1][y];
+    if (direction == Right && x < width - 1) return &maze[x + 1][y];
+    return nullptr;
+}
+
+/**
+ * Returns a reference to the flag recording whether a cell has a path in direction
+ * @param cell - the cell
+ * @param direction - direction of the path
+*/
+bool & Maze::getPath(Cell & cell, Direction direction) {
+    if (direction == Up) return cell.up_path;
+    if (direction == Down) return cell.down_path;
+    if (direction == Left) return cell.left_path;
+    return cell.right_path;
+}
+
 /**
  * helper for printMaze
  * @param x - char to print 
@@ -245,7 +523,6 @@ std::vector<std::tuple<int, int>> Maze::getRandomizedListOfWalls() {
     std::vector<std::tuple<int, int>> walls;
     for(int y = 0; y < height; y++) {
         for(int x = 0; x < width; x++) {
-            std::cout << "x: " << x << "y: " << y << std::endl;
             if (x != width -1) {
                 walls.push_back(std::make_tuple(getCellInteger(x, y), RIGHT_WALL));
             }
@@ -254,21 +531,25 @@ std::vector<std::tuple<int, int>> Maze::getRandomizedListOfWalls() {
             }
         }
     }
-    std::shuffle(walls.begin(), walls.end(), rng);
+    // Fisher-Yates shuffle; std::shuffle's use of the generator differs between standard libraries
+    for (int i = walls.size() - 1; i > 0; i--) {
+        std::swap(walls[i], walls[randomIndex(i + 1)]);
+    }
     return walls;
 }
 
 /**
- * Clears terminal window, prints current state of maze, and suspends execution for sleepTime if 
- * this->animate = true. Otherwise does nothing.
- * @param title - string to print above maze
- * @param sleepTime - length of time to sleep in microseconds, must be < 1000000
+ * Returns a uniformly distributed random integer in [0, n). Uses only the raw output of rng, which the standard
+ * fixes for std::mt19937, so a seed produces the same maze with every compiler and standard library.
+ * @param n - number of possible values, must be > 0
 */
-void Maze::animateMaze(std::string title, int sleepTime) {
-    if (this->animate) {
-        system("clear");
-        std::cout << title << "\n";
-        printMaze();
-        usleep(sleepTime);
-    }
-}
\ No newline at end of file
+int Maze::randomIndex(int n) {
+    uint32_t bound = static_cast<uint32_t>(n);
+    // reject the low values that would make the modulo biased
+    uint32_t threshold = (0u - bound) % bound;
+    uint32_t value;
+    do {
+        value = static_cast<uint32_t>(rng());
+    } while (value < threshold);
+    return value % bound;
+}
@@ -10,33 +10,75 @@
 #include <random>
 #include <string>
 #include <set>
+#include <stdint.h>
+#include <limits>
 
 #include "disjointset.h"
 
 class Maze { 
     public:
         static const int GRID_SIZE = 3;
+        // Incremented whenever the maze generated from a given size, algorithm and seed changes
+        static const int GENERATOR_VERSION = 2;
 
         // Algorithm used for maze generation
         enum Algorithm {
             DFS,
-            Kruskal
+            Kruskal,
+            HuntAndKill,
+            GrowingTreeNewest, // growing tree, always extending the most recently added cell
+            GrowingTreeRandom, // growing tree, extending a random cell
+            GrowingTreeMixed   // growing tree, choosing newest or random with equal probability
+        };
+
+        // Direction of movement between neighboring cells
+        enum Direction {
+            Up,
+            Down,
+            Left,
+            Right
         };
         
         /**
          * Constructor to create a random maze
          * @param width - number of cells in maze width
          * @param height - number of cells in maze height
-         * @param animate - show maze generation process
-         * @param algorithm - maze generation algorithm to use (DFS, Kruskal)
+         * @param deferGeneration - if true, only prepare generation; the caller runs it with generateSteps, e.g. to 
+         *                          show the generation process
+         * @param algorithm - maze generation algorithm to use (DFS, Kruskal, HuntAndKill, GrowingTree*)
+         * @param seed - seed for the random number generator. Mazes created with the same size, algorithm and seed
+         *               are identical on every platform (for the same GENERATOR_VERSION). Defaults to a random seed.
+        */
+        Maze(int width = 35, int height = 20, bool deferGeneration = false, Algorithm algorithm = DFS,
+             unsigned int seed = std::random_device{}());
+
+        /**
+         * Constructor to create a maze from passages returned by getEncodedPaths, without generating it
+         * @param width - number of cells in maze width
+         * @param height - number of cells in maze height
+         * @param paths - passages, width * height bytes (see getEncodedPaths)
+         * @param algorithm - algorithm the maze was generated with
+         * @param seed - seed the maze was generated with
         */
-        Maze(int width = 35, int height = 20, bool animate = false, Algorithm algorithm = DFS);
+        Maze(int width, int height, const std::vector<uint8_t> & paths, Algorithm algorithm, unsigned int seed);
 
         /**
          * Destructor; frees all cells associated with maze
         */
         virtual ~Maze();
 
+        /**
+         * Advances generation by up to steps steps. A step removes one wall, backtracks one cell, or (Kruskal) 
+         * rejects one wall. Returns true once generation is complete.
+         * @param steps - maximum number of steps to take
+        */
+        bool generateSteps(int steps);
+
+        /**
+         * Returns true once generation is complete
+        */
+        bool isGenerated() const;
+
         /**
          * Prints a representation of maze to console
          * @param x - optional parameter, x coordinate of point to mark on maze
@@ -46,6 +88,15 @@ class Maze {
         */
         void printMaze(int x = -1, int y = -1, const std::set<int> * positions = nullptr);
 
+        /**
+         * Prints the marker character of a single cell, the character between the cell's floor and right wall
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param isMarked - whether to mark the cell as the current point on the maze
+         * @param positions - optional parameter, set of positions to demarcate (see printMaze)
+        */
+        void printCellMarker(int x, int y, bool isMarked, const std::set<int> * positions = nullptr);
+
         /**
          * Struct representing each cell in the maze. Comtaining the cell's x and y coordinates, visited status, 
          * and how it is connected to neighboring cells.
@@ -59,6 +110,7 @@ class Maze {
             bool up_path = false;
             bool down_path = false;
             bool isVisited = false;
+            bool isActive = false; // used by growing tree generation, cell may still have unvisited neighbors
         };
 
         /**
@@ -78,33 +130,112 @@ class Maze {
         */
         int getHeight();
 
+        /**
+         * Opens the wall between a cell and its neighbor in direction. Returns false if the cell has no neighbor in
+         * direction or there is already a path.
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param direction - direction of the neighbor
+        */
+        bool openWall(int x, int y, Direction direction);
+
+        /**
+         * Closes the path between a cell and its neighbor in direction. Returns false if the cell has no neighbor in
+         * direction or there is already a wall.
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param direction - direction of the neighbor
+        */
+        bool closeWall(int x, int y, Direction direction);
+
+        /**
+         * Returns the maze's passages, one byte per cell in row-major order (getCellInteger). Bit 0 of a cell's byte
+         * is set if there is a path to the right, bit 1 if there is a path down.
+        */
+        std::vector<uint8_t> getEncodedPaths() const;
+
+        /**
+         * Returns the algorithm used to generate the maze
+        */
+        Algorithm getAlgorithm();
+
+        /**
+         * Returns the seed used to generate the maze
+        */
+        unsigned int getSeed();
+
         friend class MazeSolver;
 
     private:
+        // Cell selection policy for growing tree generation
+        enum SelectionPolicy {
+            Newest,
+            Random,
+            Mixed
+        };
+
+        // State of an in-progress generation, so generation can be advanced a number of steps at a time
+        struct GenerationState {
+            bool isComplete = false;
+            std::vector<Cell*> stack; // DFS: path from the starting cell to the current cell
+            std::vector<std::tuple<int, int>> walls; // Kruskal: randomized list of walls
+            size_t nextWall = 0; // Kruskal: index of the next wall to consider
+            DisjointSet cellSet = DisjointSet(0); // Kruskal: sets of connected cells
+            Cell * cell = nullptr; // hunt-and-kill and growing tree: cell currently being extended
+            int huntRow = 0; // hunt-and-kill: first row that may contain unvisited cells
+            SelectionPolicy policy = Newest; // growing tree
+            std::vector<int> activeInRow; // growing tree: number of active cells in each row
+            int activeCount = 0; // growing tree: total number of active cells
+        };
+
         int width;
         int height;
         struct Cell** maze;
-        bool animate;
+        Algorithm algorithm;
+        unsigned int seed;
         std::mt19937 rng;
+        GenerationState generation;
+
+        /**
+         * Sets up the generation state for this->algorithm
+        */
+        void startGeneration();
+
+        /**
+         * One step of depth-first search generation, starting at maze center. Returns false if generation is complete.
+        */
+        bool dfsStep();
+
+        /**
+         * One step of Kruskal's algorithm. Returns false if generation is complete.
+        */
+        bool kruskalStep();
 
         /**
-         * Randomly generates a maze
-         * @param width - maze width
-         * @param height - maze height
-         * @param algorithm - maze generation algorithm to use
+         * One step of the hunt-and-kill algorithm, starting at maze center. Uses no stack; when the walk reaches a
+         * dead end, rows are scanned from the first row that still has unvisited cells for an unvisited cell next to
+         * a visited one. Returns false if generation is complete.
         */
-        void generateMaze(int width, int height, Algorithm algorithm);
+        bool huntAndKillStep();
 
         /**
-         * Recursively generates maze using depth-first search.
-         * @param cell - the starting cell for maze generation
+         * Scans rows from generation.huntRow for an unvisited cell bordering a visited cell, and connects it to a 
+         * random visited neighbor. Returns the connected cell, or nullptr if every cell has been visited. 
+         * generation.huntRow is advanced past rows found to be complete.
         */
-        void recursivelyGenerateMaze(Cell & cell);
+        Cell * huntForUnvisitedCell();
 
         /**
-         * Generates maze using Kruskal's algorithm
+         * One step of the growing tree algorithm, starting at maze center. The set of active cells is stored in the 
+         * grid (Cell::isActive) with a count of active cells per row, so only row-sized extra memory is used.
+         * Returns false if generation is complete.
         */
-        void kruskalGenerateMaze();
+        bool growingTreeStep();
+
+        /**
+         * Returns a uniformly random active cell. Used by growing tree generation; generation.activeCount must be > 0.
+        */
+        Cell * getRandomActiveCell();
 
         /**
          * Returns a list of pointers to all of a cell's unvisited neighbors. The cells directly above, below, right
@@ -123,6 +254,21 @@ class Maze {
         */
         void removeWall(Cell & cellA, Cell & cellB);
 
+        /**
+         * Returns the cell's neighbor in direction, or nullptr if it is on the maze edge
+         * @param x - x coordinate of the cell
+         * @param y - y coordinate of the cell
+         * @param direction - direction of the neighbor
+        */
+        Cell * getNeighbor(int x, int y, Direction direction);
+
+        /**
+         * Returns a reference to the flag recording whether a cell has a path in direction
+         * @param cell - the cell
+         * @param direction - direction of the path
+        */
+        static bool & getPath(Cell & cell, Direction direction);
+
         /**
          * helper for printMaze
          * @param x - char to print
@@ -145,11 +291,11 @@ class Maze {
         std::vector<std::tuple<int, int>> getRandomizedListOfWalls();
 
         /**
-         * Clears terminal window, prints current state of maze, and suspends execution for sleepTime
-         * @param title - string to print above maze
-         * @param sleepTime - length of time to sleep in microseconds, must be < 1000000
+         * Returns a uniformly distributed random integer in [0, n). Uses only the raw output of rng, which the 
+         * standard fixes for std::mt19937, so a seed produces the same maze with every compiler and standard library.
+         * @param n - number of possible values, must be > 0
         */
-        void animateMaze(std::string title, int sleepTime = 30000);
+        int randomIndex(int n);
 
 };
 
@@ -0,0 +1,250 @@
+#include "mazecache.h"
+#include "binaryio.h"
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+
+static const uint32_t CACHE_FILE_MAGIC = 0x4d5a4332; // "MZC2", files from older formats read as misses
+static const std::string CACHE_FILE_EXTENSION = ".maze";
+// stores between recounts of the directory, which other processes may also be adding files to
+static const int RECOUNT_INTERVAL = 256;
+
+/**
+ * Returns true if towardGoal is a valid step table for a maze: every step follows a passage and every cell's
+ * steps reach the goal. Cache files may be shared with other processes, and a corrupted table could otherwise
+ * send a walk to the goal round a cycle forever. Takes O(cells) time.
+ * @param paths - maze passages (see Maze::getEncodedPaths)
+ * @param width - maze width
+ * @param towardGoal - each cell's next cell on its path to the goal, each < paths.size()
+*/
+static bool isValidStepTable(const std::vector<uint8_t> & paths, int width, const std::vector<uint32_t> & towardGoal) {
+    const uint32_t cells = paths.size();
+    const uint32_t goal = cells - 1;
+    const uint32_t rowLength = width;
+    if (towardGoal[goal] != goal) return false;
+    // 0 - not yet checked, 1 - on the walk being checked, 2 - known to reach the goal
+    std::vector<uint8_t> state(cells, 0);
+    state[goal] = 2;
+    std::vector<uint32_t> walk;
+    for (uint32_t start = 0; start < cells; start++) {
+        uint32_t cell = start;
+        while (state[cell] == 0) {
+            uint32_t next = towardGoal[cell];
+            bool isPassage = (next == cell + 1 && next % rowLength != 0 && (paths[cell] & 1)) ||
+                             (next == cell + rowLength && (paths[cell] & 2)) ||
+                             (next + 1 == cell && cell % rowLength != 0 && (paths[next] & 1)) ||
+                             (next + rowLength == cell && (paths[next] & 2));
+            if (!isPassage) return false;
+            state[cell] = 1;
+            walk.push_back(cell);
+            cell = next;
+        }
+        if (state[cell] == 1) return false; // walked into a cycle
+        for (uint32_t walked : walk) {
+            state[walked] = 2;
+        }
+        walk.clear();
+    }
+    return true;
+}
+
+/**
+ * Constructor to create a maze cache. Creates the directory if it doesn't exist.
+ * @param directory - directory to store cached mazes in
+ * @param maxBytes - maximum total size of cached files
+*/
+MazeCache::MazeCache(std::string directory, uint64_t maxBytes)
+    : directory(directory),
+      maxBytes(maxBytes),
+      hits(0),
+      misses(0),
+      temporaryFiles(0),
+      storedBytes(0),
+      storesSinceCount(0)
+{
+    mkdir(directory.c_str(), 0755);
+    evict(); // counts the files already stored
+}
+
+/**
+ * Returns the maze for the given parameters and its solution. On a cache hit the maze is read from disk 
+ * without generating or solving it; on a miss it is generated, solved and stored.
+ * @param width - number of cells in maze width
+ * @param height - number of cells in maze height
+ * @param algorithm - maze generation algorithm to use
+ * @param seed - seed for the random number generator
+ * @param towardGoal - set to each cell's next cell on its path to the goal (see MazeSolver::getStepsTowardGoal)
+*/
+std::unique_ptr<Maze> MazeCache::getMaze(int width, int height, Maze::Algorithm algorithm, unsigned int seed,
+                                         std::vector<uint32_t> & towardGoal) {
+    std::string path = getPath(width, height, algorithm, seed);
+    auto maze = load(path, width, height, algorithm, seed, towardGoal);
+    if (maze != nullptr) {
+        hits++;
+        utimensat(AT_FDCWD, path.c_str(), nullptr, 0); // mark as recently used
+        return maze;
+    }
+    misses++;
+    maze = std::make_unique<Maze>(width, height, false, algorithm, seed);
+    towardGoal = MazeSolver::getStepsTowardGoal(maze->getEncodedPaths(), width, height);
+    store(path, *maze, towardGoal);
+    return maze;
+}
+
+/**
+ * Returns the number of getMaze calls answered from disk
+*/
+int MazeCache::getHits() {
+    return hits;
+}
+
+/**
+ * Returns the number of getMaze calls that generated a maze
+*/
+int MazeCache::getMisses() {
+    return misses;
+}
+
+/**
+ * Returns the path of the file storing a maze
+ * @param width - maze width
+ * @param height - maze height
+ * @param algorithm - maze generation algorithm
+ * @param seed - maze seed
+*/
+std::string MazeCache::getPath(int width, int height, Maze::Algorithm algorithm, unsigned int seed) {
+    // 64 bit FNV-1a hash of the key
+    const uint32_t key[] = { static_cast<uint32_t>(width), static_cast<uint32_t>(height), 
+                             static_cast<uint32_t>(algorithm), seed, static_cast<uint32_t>(Maze::GENERATOR_VERSION) };
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint32_t value : key) {
+        for (int i = 0; i < 4; i++) {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    }
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(hash));
+    return directory + "/" + name + CACHE_FILE_EXTENSION;
+}
+
+/**
+ * Reads a cached maze. Returns nullptr if the file is missing, does not hold the requested maze, or its 
+ * step table does not lead every cell to the goal.
+ * @param path - file to read
+ * @param width - maze width
+ * @param height - maze height
+ * @param algorithm - maze generation algorithm
+ * @param seed - maze seed
+ * @param towardGoal - set to each cell's next cell on its path to the goal
+*/
+std::unique_ptr<Maze> MazeCache::load(std::string path, int width, int height, Maze::Algorithm algorithm, 
+                                      unsigned int seed, std::vector<uint32_t> & towardGoal) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t header[6];
+    for (uint32_t & value : header) {
+        if (!readUint32(in, value)) return nullptr;
+    }
+    // the whole key is stored, so a hash collision reads as a miss
+    if (header[0] != CACHE_FILE_MAGIC || header[1] != static_cast<uint32_t>(Maze::GENERATOR_VERSION) ||
+        header[2] != static_cast<uint32_t>(width) || header[3] != static_cast<uint32_t>(height) ||
+        header[4] != static_cast<uint32_t>(algorithm) || header[5] != seed) {
+        return nullptr;
+    }
+    std::vector<uint8_t> paths(width * height);
+    if (!in.read(reinterpret_cast<char*>(paths.data()), paths.size())) return nullptr;
+    std::vector<uint32_t> steps(paths.size());
+    for (uint32_t & cell : steps) {
+        if (!readUint32(in, cell) || cell >= paths.size()) return nullptr;
+    }
+    if (!isValidStepTable(paths, width, steps)) return nullptr;
+    towardGoal.swap(steps);
+    return std::make_unique<Maze>(width, height, paths, algorithm, seed);
+}
+
+/**
+ * Writes a maze and its solution to the cache, then evicts files if the running total is over the size limit
+ * @param path - file to write
+ * @param maze - the maze
+ * @param towardGoal - each cell's next cell on its path to the goal
+*/
+void MazeCache::store(std::string path, Maze & maze, const std::vector<uint32_t> & towardGoal) {
+    // write to a temporary file and rename, so other processes never read a partly written file
+    std::string temporaryPath = path + ".tmp" + std::to_string(getpid()) + "-" + std::to_string(temporaryFiles++);
+    {
+        std::ofstream out(temporaryPath, std::ios::binary);
+        writeUint32(out, CACHE_FILE_MAGIC);
+        writeUint32(out, Maze::GENERATOR_VERSION);
+        writeUint32(out, maze.getWidth());
+        writeUint32(out, maze.getHeight());
+        writeUint32(out, maze.getAlgorithm());
+        writeUint32(out, maze.getSeed());
+        std::vector<uint8_t> paths = maze.getEncodedPaths();
+        out.write(reinterpret_cast<const char*>(paths.data()), paths.size());
+        for (uint32_t cell : towardGoal) {
+            writeUint32(out, cell);
+        }
+        if (!out) {
+            out.close();
+            unlink(temporaryPath.c_str());
+            return;
+        }
+    }
+    struct stat info;
+    if (stat(temporaryPath.c_str(), &info) != 0 || rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        unlink(temporaryPath.c_str());
+        return;
+    }
+    // only list the directory when the running total says it is over the limit, or to pick up other processes' files
+    storedBytes += info.st_size;
+    if (storedBytes > maxBytes || ++storesSinceCount >= RECOUNT_INTERVAL) evict();
+}
+
+/**
+ * Counts the cache files and removes the least recently used ones until their total size is at most maxBytes.
+ * Resets storedBytes to the total that remains.
+*/
+void MazeCache::evict() {
+    std::unique_lock<std::mutex> lock(evictMutex, std::try_to_lock);
+    if (!lock.owns_lock()) return; // another thread is already counting
+    storesSinceCount = 0;
+    DIR * dir = opendir(directory.c_str());
+    if (dir == nullptr) return;
+    // (last use time, size, path) of every cache file
+    std::vector<std::tuple<struct timespec, uint64_t, std::string>> files;
+    uint64_t totalBytes = 0;
+    struct dirent * entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() <= CACHE_FILE_EXTENSION.size() || 
+            name.compare(name.size() - CACHE_FILE_EXTENSION.size(), std::string::npos, CACHE_FILE_EXTENSION) != 0) {
+            continue;
+        }
+        std::string path = directory + "/" + name;
+        struct stat info;
+        if (stat(path.c_str(), &info) != 0) continue;
+        files.push_back(std::make_tuple(info.st_mtim, static_cast<uint64_t>(info.st_size), path));
+        totalBytes += info.st_size;
+    }
+    closedir(dir);
+    if (totalBytes <= maxBytes) {
+        storedBytes = totalBytes;
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const std::tuple<struct timespec, uint64_t, std::string> & a,
+                                             const std::tuple<struct timespec, uint64_t, std::string> & b) {
+        const struct timespec & timeA = std::get<0>(a);
+        const struct timespec & timeB = std::get<0>(b);
+        return timeA.tv_sec < timeB.tv_sec || (timeA.tv_sec == timeB.tv_sec && timeA.tv_nsec < timeB.tv_nsec);
+    });
+    for (const auto & file : files) {
+        if (totalBytes <= maxBytes) break;
+        if (unlink(std::get<2>(file).c_str()) == 0) totalBytes -= std::get<1>(file);
+    }
+    storedBytes = totalBytes;
+}
@@ -0,0 +1,102 @@
+#ifndef MAZECACHE_H_
+#define MAZECACHE_H_
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+#include "maze.h"
+#include "mazesolver.h"
+
+/**
+ * On-disk cache of generated mazes and their solutions. Each maze is stored in its own file, named by a hash of 
+ * (width, height, algorithm, seed, Maze::GENERATOR_VERSION), so a cache directory can be shared between runs 
+ * and processes. The total size of cached files is bounded; least recently used files are removed first.
+ * getMaze may be called from several threads at once.
+*/
+class MazeCache { 
+    public:
+        /**
+         * Constructor to create a maze cache. Creates the directory if it doesn't exist.
+         * @param directory - directory to store cached mazes in
+         * @param maxBytes - maximum total size of cached files
+        */
+        MazeCache(std::string directory, uint64_t maxBytes = 256 * 1024 * 1024);
+
+        /**
+         * Returns the maze for the given parameters and its solution. On a cache hit the maze is read from disk 
+         * without generating or solving it; on a miss it is generated, solved and stored.
+         * @param width - number of cells in maze width
+         * @param height - number of cells in maze height
+         * @param algorithm - maze generation algorithm to use
+         * @param seed - seed for the random number generator
+         * @param towardGoal - set to each cell's next cell on its path to the goal (see MazeSolver::getStepsTowardGoal)
+        */
+        std::unique_ptr<Maze> getMaze(int width, int height, Maze::Algorithm algorithm, unsigned int seed,
+                                      std::vector<uint32_t> & towardGoal);
+
+        /**
+         * Returns the number of getMaze calls answered from disk
+        */
+        int getHits();
+
+        /**
+         * Returns the number of getMaze calls that generated a maze
+        */
+        int getMisses();
+
+    private:
+        std::string directory;
+        uint64_t maxBytes;
+        std::atomic<int> hits;
+        std::atomic<int> misses;
+        std::atomic<int> temporaryFiles; // number of temporary files written, makes their names unique
+        std::atomic<uint64_t> storedBytes; // total size of cache files, as of the last count plus stores since
+        std::atomic<int> storesSinceCount;
+        std::mutex evictMutex;
+
+        /**
+         * Returns the path of the file storing a maze
+         * @param width - maze width
+         * @param height - maze height
+         * @param algorithm - maze generation algorithm
+         * @param seed - maze seed
+        */
+        std::string getPath(int width, int height, Maze::Algorithm algorithm, unsigned int seed);
+
+        /**
+         * Reads a cached maze. Returns nullptr if the file is missing, does not hold the requested maze, or its 
+         * step table does not lead every cell to the goal.
+         * @param path - file to read
+         * @param width - maze width
+         * @param height - maze height
+         * @param algorithm - maze generation algorithm
+         * @param seed - maze seed
+         * @param towardGoal - set to each cell's next cell on its path to the goal
+        */
+        std::unique_ptr<Maze> load(std::string path, int width, int height, Maze::Algorithm algorithm, 
+                                   unsigned int seed, std::vector<uint32_t> & towardGoal);
+
+        /**
+         * Writes a maze and its solution to the cache, then evicts files if the running total is over the size limit
+         * @param path - file to write
+         * @param maze - the maze
+         * @param towardGoal - each cell's next cell on its path to the goal
+        */
+        void store(std::string path, Maze & maze, const std::vector<uint32_t> & towardGoal);
+
+        /**
+         * Counts the cache files and removes the least recently used ones until their total size is at most 
+         * maxBytes. Resets storedBytes to the total that remains.
+        */
+        void evict();
+
+};
+
+#endif
@@ -0,0 +1,457 @@
+#include "mazeserver.h"
+#include "binaryio.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+
+static const size_t LATENCY_SAMPLES = 1 << 16; // most recent requests kept per op for percentiles
+static const size_t MAX_BUFFERED_INPUT = 64 * MazeServer::REQUEST_SIZE; // pipelined requests read ahead
+static const size_t MAX_CACHED_BYTES = size_t(1) << 30; // memory cache limit, however few entries it holds
+static const int ACCEPT_RETRY_TIME = 100; // milliseconds to wait before accepting again after accept fails
+static const int STOP_SIGNALS[] = { SIGINT, SIGTERM };
+
+// set by handleStopSignal; a signal handler can only reach the running server through static state
+static volatile sig_atomic_t stopRequested = 0;
+static int stopSignalPipe = -1;
+
+/**
+ * Constructor to create a maze server
+ * @param socketPath - file system path of the Unix domain socket to listen on
+ * @param threadCount - number of worker threads serving connections
+ * @param cacheCapacity - maximum number of mazes kept in the cache, which is also limited to 1 GiB
+ * @param diskCache - optional on-disk cache consulted when a maze is not cached in memory
+ * @param maxCells - largest maze served; requests for larger mazes are answered with TOO_LARGE
+*/
+MazeServer::MazeServer(std::string socketPath, int threadCount, int cacheCapacity, MazeCache * diskCache, 
+                       int maxCells)
+    : socketPath(socketPath),
+      listenSocket(-1),
+      stopping(false),
+      cacheCapacity(std::max(1, cacheCapacity)),
+      maxCells(maxCells),
+      cachedBytes(0),
+      diskCache(diskCache)
+{
+    if (pipe(wakePipe) == 0) {
+        fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(wakePipe[1], F_SETFL, O_NONBLOCK); // a full pipe already has a wake up pending
+    } else {
+        wakePipe[0] = wakePipe[1] = -1;
+    }
+    for (int i = 0; i < std::max(1, threadCount); i++) {
+        workers.emplace_back(&MazeServer::serveClients, this);
+    }
+}
+
+/**
+ * Destructor; stops worker threads and removes the socket
+*/
+MazeServer::~MazeServer() {
+    {
+        std::lock_guard<std::mutex> lock(clientsMutex);
+        stopping = true;
+    }
+    clientsAvailable.notify_all();
+    for (auto & worker : workers) {
+        worker.join();
+    }
+    if (listenSocket >= 0) {
+        close(listenSocket);
+        unlink(socketPath.c_str());
+    }
+    if (wakePipe[0] >= 0) {
+        close(wakePipe[0]);
+        close(wakePipe[1]);
+    }
+}
+
+/**
+ * Listens on the socket and serves requests until SIGINT or SIGTERM is received. Returns false if the
+ * socket could not be created.
+*/
+bool MazeServer::run() {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (wakePipe[0] < 0 || socketPath.size() >= sizeof(address.sun_path)) return false;
+    strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket < 0) return false;
+    unlink(socketPath.c_str()); // remove socket left by a previous server
+    if (bind(listenSocket, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenSocket, SOMAXCONN) != 0) {
+        close(listenSocket);
+        listenSocket = -1;
+        return false;
+    }
+
+    fcntl(listenSocket, F_SETFL, O_NONBLOCK); // a connection may be aborted between poll and accept
+
+    stopRequested = 0;
+    stopSignalPipe = wakePipe[1];
+    struct sigaction action, previous[2];
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleStopSignal;
+    sigemptyset(&action.sa_mask);
+    for (int i = 0; i < 2; i++) {
+        sigaction(STOP_SIGNALS[i], &action, &previous[i]);
+    }
+    pollClients();
+    for (int i = 0; i < 2; i++) {
+        sigaction(STOP_SIGNALS[i], &previous[i], nullptr);
+    }
+    stopSignalPipe = -1;
+    return true;
+}
+
+/**
+ * Polls the listening socket and connections, accepting new connections, reading requests and queueing 
+ * them for the workers, and sending their responses, until a stop signal arrives
+*/
+void MazeServer::pollClients() {
+    std::map<int, Connection> connections;
+    std::vector<struct pollfd> polled;
+    std::vector<int> polledClients; // socket of each polled connection; polled holds -1 for ones not polled
+    auto acceptRetry = std::chrono::steady_clock::now();
+    while (!stopRequested) {
+        // while accept is failing (e.g. out of file descriptors) stop polling the listening socket for a while
+        // rather than spinning on a connection that can't be accepted
+        auto now = std::chrono::steady_clock::now();
+        bool accepting = now >= acceptRetry;
+        int timeout = accepting ? -1 :
+            static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(acceptRetry - now).count()) + 1;
+
+        polled.clear();
+        polledClients.clear();
+        polled.push_back({ wakePipe[0], POLLIN, 0 });
+        polled.push_back({ accepting ? listenSocket : -1, POLLIN, 0 }); // negative descriptors are ignored
+        for (auto & entry : connections) {
+            const Connection & connection = entry.second;
+            short events = 0;
+            if (!connection.isClosing && !connection.isFailed && connection.input.size() < MAX_BUFFERED_INPUT) {
+                events |= POLLIN;
+            }
+            if (!connection.isFailed && connection.outputSent < connection.output.size()) events |= POLLOUT;
+            // a hung up socket always polls ready, so only poll connections waiting for the socket
+            polled.push_back({ events ? entry.first : -1, events, 0 });
+            polledClients.push_back(entry.first);
+        }
+        if (poll(polled.data(), polled.size(), timeout) < 0) continue; // interrupted by a signal
+
+        if (polled[0].revents) {
+            char buffer[64];
+            while (read(wakePipe[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            for (auto & response : responses) {
+                Connection & connection = connections[response.first];
+                connection.output.swap(response.second);
+                connection.outputSent = 0;
+                connection.isBusy = false;
+                if (!connection.isFailed) writeOutput(response.first, connection);
+            }
+            responses.clear();
+        }
+        for (size_t i = 0; i < polledClients.size(); i++) {
+            Connection & connection = connections[polledClients[i]];
+            if (polled[i + 2].revents & POLLIN) readInput(polledClients[i], connection);
+            if (polled[i + 2].revents & POLLOUT) writeOutput(polledClients[i], connection);
+            if (polled[i + 2].revents & (POLLERR | POLLNVAL)) connection.isFailed = true;
+            if ((polled[i + 2].revents & POLLHUP) && !(polled[i + 2].revents & POLLIN)) connection.isClosing = true;
+        }
+
+        // queue one complete request per connection that has finished sending its last response
+        std::vector<Request> requests;
+        for (auto it = connections.begin(); it != connections.end();) {
+            Connection & connection = it->second;
+            bool isIdle = !connection.isBusy && connection.outputSent == connection.output.size();
+            if (connection.isFailed ? !connection.isBusy : (isIdle && connection.isClosing && 
+                                                           connection.input.size() < REQUEST_SIZE)) {
+                close(it->first);
+                it = connections.erase(it);
+                continue;
+            }
+            if (!connection.isFailed && isIdle && connection.input.size() >= REQUEST_SIZE) {
+                Request request;
+                request.client = it->first;
+                memcpy(request.bytes, connection.input.data(), REQUEST_SIZE);
+                connection.input.erase(connection.input.begin(), connection.input.begin() + REQUEST_SIZE);
+                connection.isBusy = true;
+                requests.push_back(request);
+            }
+            ++it;
+        }
+
+        if (polled[1].revents) {
+            int client = accept(listenSocket, nullptr, nullptr);
+            if (client >= 0) {
+                fcntl(client, F_SETFL, O_NONBLOCK);
+                connections[client] = Connection();
+            } else if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                acceptRetry = std::chrono::steady_clock::now() + std::chrono::milliseconds(ACCEPT_RETRY_TIME);
+            }
+        }
+
+        if (!requests.empty()) {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            for (const Request & request : requests) {
+                pendingRequests.push(request);
+                clientsAvailable.notify_one();
+            }
+        }
+    }
+    // workers may still be answering requests; their responses are discarded by the destructor
+    for (auto & entry : connections) {
+        close(entry.first);
+    }
+}
+
+/**
+ * Reads whatever input is available on a connection without blocking. Stops reading once a bounded 
+ * number of requests are buffered.
+ * @param client - connected socket
+ * @param connection - the connection's buffers
+*/
+void MazeServer::readInput(int client, Connection & connection) {
+    uint8_t buffer[MAX_BUFFERED_INPUT];
+    while (connection.input.size() < MAX_BUFFERED_INPUT) {
+        ssize_t bytesRead = read(client, buffer, MAX_BUFFERED_INPUT - connection.input.size());
+        if (bytesRead > 0) {
+            connection.input.insert(connection.input.end(), buffer, buffer + bytesRead);
+        } else if (bytesRead == 0) {
+            connection.isClosing = true;
+            return;
+        } else {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) connection.isFailed = true;
+            return;
+        }
+    }
+}
+
+/**
+ * Sends as much of a connection's pending response as the socket accepts without blocking
+ * @param client - connected socket
+ * @param connection - the connection's buffers
+*/
+void MazeServer::writeOutput(int client, Connection & connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t bytesWritten = send(client, connection.output.data() + connection.outputSent, 
+                                    connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (bytesWritten < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) connection.isFailed = true;
+            return;
+        }
+        connection.outputSent += bytesWritten;
+    }
+    // release the response, which may be large, once it has been sent
+    connection.output.clear();
+    connection.output.shrink_to_fit();
+    connection.outputSent = 0;
+}
+
+/**
+ * Signal handler for SIGINT and SIGTERM; wakes run() so it stops serving
+ * @param signal - the signal received
+*/
+void MazeServer::handleStopSignal(int) {
+    int savedErrno = errno;
+    stopRequested = 1;
+    if (stopSignalPipe >= 0) {
+        char wake = 0;
+        ssize_t ignored = write(stopSignalPipe, &wake, 1);
+        (void)ignored;
+    }
+    errno = savedErrno;
+}
+
+/**
+ * Worker thread; answers requests from pendingRequests, passing each response back to run(), until the 
+ * server stops
+*/
+void MazeServer::serveClients() {
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(clientsMutex);
+            clientsAvailable.wait(lock, [this] { return stopping || !pendingRequests.empty(); });
+            if (stopping) return;
+            request = pendingRequests.front();
+            pendingRequests.pop();
+        }
+        std::vector<uint8_t> response;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            handleRequest(request.bytes, response);
+        } catch (const std::bad_alloc &) {
+            response.assign(RESPONSE_HEADER_SIZE, 0);
+            response[0] = TOO_LARGE;
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        if (request.bytes[0] >= GENERATE && request.bytes[0] < STATS) {
+            recordLatency(request.bytes[0], static_cast<uint32_t>(elapsed.count()));
+        }
+        {
+            std::lock_guard<std::mutex> lock(clientsMutex);
+            responses.push_back(std::make_pair(request.client, std::move(response)));
+        }
+        char wake = 0;
+        ssize_t ignored = write(wakePipe[1], &wake, 1);
+        (void)ignored;
+    }
+}
+
+/**
+ * Builds the response to a request
+ * @param request - REQUEST_SIZE bytes
+ * @param response - filled with response header and payload
+*/
+void MazeServer::handleRequest(const uint8_t * request, std::vector<uint8_t> & response) {
+    int op = request[0];
+    int algorithm = request[1];
+    int width = readLittleEndian(request + 2, 2);
+    int height = readLittleEndian(request + 4, 2);
+    int x = readLittleEndian(request + 6, 2);
+    int y = readLittleEndian(request + 8, 2);
+    uint32_t seed = readLittleEndian(request + 12, 4);
+
+    response.assign(RESPONSE_HEADER_SIZE, 0);
+    if (op == STATS) {
+        appendStats(response);
+    } else if (op < GENERATE || op > STATS || algorithm > Maze::GrowingTreeMixed || width <= 0 || height <= 0 ||
+               (op == PATH_QUERY && (x >= width || y >= height))) {
+        response[0] = BAD_REQUEST;
+    } else if (static_cast<int64_t>(width) * height > maxCells) {
+        response[0] = TOO_LARGE;
+    } else {
+        auto entry = getMaze(std::make_tuple(width, height, algorithm, seed));
+        if (op == GENERATE) {
+            response.resize(RESPONSE_HEADER_SIZE + entry->paths.size());
+            memcpy(response.data() + RESPONSE_HEADER_SIZE, entry->paths.data(), entry->paths.size());
+        } else if (op == SOLVE) {
+            for (uint32_t cell : entry->solution) {
+                appendUint32(response, cell);
+            }
+        } else {
+            uint32_t goal = width * height - 1;
+            uint32_t cell = y * width + x;
+            appendUint32(response, cell);
+            while (cell != goal) {
+                cell = entry->towardGoal[cell];
+                appendUint32(response, cell);
+            }
+        }
+    }
+    uint32_t payloadLength = response.size() - RESPONSE_HEADER_SIZE;
+    for (int i = 0; i < 4; i++) {
+        response[4 + i] = static_cast<uint8_t>((payloadLength >> (8 * i)) & 0xff);
+    }
+}
+
+/**
+ * Returns the cached maze for key, generating and solving it on a miss
+ * @param key - maze width, height, algorithm and seed
+*/
+std::shared_ptr<const MazeServer::CacheEntry> MazeServer::getMaze(const CacheKey & key) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto found = cache.find(key);
+        if (found != cache.end()) {
+            recentlyUsed.splice(recentlyUsed.begin(), recentlyUsed, found->second.second);
+            return found->second.first;
+        }
+    }
+
+    // generate outside the lock so other requests aren't blocked; concurrent misses on one key may both generate
+    auto entry = createEntry(key);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (cache.find(key) == cache.end()) {
+        recentlyUsed.push_front(key);
+        cache[key] = std::make_pair(entry, recentlyUsed.begin());
+        cachedBytes += getEntryBytes(*entry);
+        while (static_cast<int>(cache.size()) > cacheCapacity || (cachedBytes > MAX_CACHED_BYTES && cache.size() > 1)) {
+            auto evicted = cache.find(recentlyUsed.back());
+            cachedBytes -= getEntryBytes(*evicted->second.first);
+            cache.erase(evicted);
+            recentlyUsed.pop_back();
+        }
+    }
+    return entry;
+}
+
+/**
+ * Returns the memory used by a cache entry's tables
+ * @param entry - the entry
+*/
+size_t MazeServer::getEntryBytes(const CacheEntry & entry) {
+    return entry.paths.size() + sizeof(uint32_t) * (entry.solution.size() + entry.towardGoal.size());
+}
+
+/**
+ * Generates (or reads from the disk cache) and solves a maze
+ * @param key - maze width, height, algorithm and seed
+*/
+std::shared_ptr<const MazeServer::CacheEntry> MazeServer::createEntry(const CacheKey & key) {
+    auto entry = std::make_shared<CacheEntry>();
+    entry->width = std::get<0>(key);
+    entry->height = std::get<1>(key);
+    Maze::Algorithm algorithm = static_cast<Maze::Algorithm>(std::get<2>(key));
+    if (diskCache != nullptr) {
+        // the disk cache stores the steps toward the goal with the maze, so a hit needs no solving
+        entry->paths = diskCache->getMaze(entry->width, entry->height, algorithm, std::get<3>(key), 
+                                          entry->towardGoal)->getEncodedPaths();
+    } else {
+        Maze maze(entry->width, entry->height, false, algorithm, std::get<3>(key));
+        entry->paths = maze.getEncodedPaths();
+        entry->towardGoal = MazeSolver::getStepsTowardGoal(entry->paths, entry->width, entry->height);
+    }
+
+    uint32_t goal = entry->width * entry->height - 1;
+    for (uint32_t cell = 0; cell != goal; cell = entry->towardGoal[cell]) {
+        entry->solution.push_back(cell);
+    }
+    entry->solution.push_back(goal);
+    return entry;
+}
+
+/**
+ * Records the latency of a request
+ * @param op - request op
+ * @param microseconds - time taken to build the response
+*/
+void MazeServer::recordLatency(int op, uint32_t microseconds) {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    LatencyLog & log = latencies[op - 1];
+    if (log.samples.size() < LATENCY_SAMPLES) {
+        log.samples.push_back(microseconds);
+    } else {
+        log.samples[log.next] = microseconds;
+    }
+    log.next = (log.next + 1) % LATENCY_SAMPLES;
+    log.count++;
+}
+
+/**
+ * Appends the STATS payload to response
+ * @param response - response to append to
+*/
+void MazeServer::appendStats(std::vector<uint8_t> & response) {
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    for (const LatencyLog & log : latencies) {
+        std::vector<uint32_t> sorted = log.samples;
+        std::sort(sorted.begin(), sorted.end());
+        appendUint32(response, log.count);
+        const double percentiles[] = { 0.5, 0.9, 0.99, 1.0 };
+        for (double percentile : percentiles) {
+            appendUint32(response, sorted.empty() ? 0 : sorted[static_cast<size_t>(percentile * (sorted.size() - 1))]);
+        }
+    }
+}
@@ -0,0 +1,215 @@
+#ifndef MAZESERVER_H_
+#define MAZESERVER_H_
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+#include <queue>
+#include <tuple>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <stdint.h>
+
+#include "maze.h"
+#include "mazesolver.h"
+#include "mazecache.h"
+
+/**
+ * Serves maze generation, solving and path queries to local processes over a Unix domain socket.
+ *
+ * Protocol (all integers little endian). Each request is a fixed 16 byte message:
+ *      uint8 op, uint8 algorithm (Maze::Algorithm), uint16 width, uint16 height, uint16 x, uint16 y,
+ *      uint16 reserved, uint32 seed
+ * and is answered with an 8 byte header followed by payloadLength bytes:
+ *      uint8 status, uint8[3] reserved, uint32 payloadLength
+ * Ops:
+ *      GENERATE   - payload is width * height bytes, Maze::getEncodedPaths()
+ *      SOLVE      - payload is the uint32 cell numbers (getCellInteger) of the solution, in order from (0,0) to the goal
+ *      PATH_QUERY - payload is the uint32 cell numbers of the path from (x, y) to the goal
+ *      STATS      - payload is, for GENERATE, SOLVE and PATH_QUERY in turn, uint32 request count followed by
+ *                   uint32 50th, 90th, 99th percentile and maximum latency in microseconds
+ * A connection may send any number of requests. Connections are non-blocking and all socket reads and writes are
+ * done by the thread calling run(): it buffers each connection's input, queues each complete request to the
+ * thread pool, and sends the response as fast as the client reads it. Workers never wait on a socket, so slow
+ * clients can't hold them. Requests too large to allocate for are answered with TOO_LARGE. SIGINT and SIGTERM stop the server and remove
+ * the socket. Mazes are cached in memory, and optionally on disk (MazeCache) so they survive server restarts.
+*/
+class MazeServer { 
+    public:
+        enum Op {
+            GENERATE = 1,
+            SOLVE = 2,
+            PATH_QUERY = 3,
+            STATS = 4
+        };
+
+        enum Status {
+            OK = 0,
+            BAD_REQUEST = 1,
+            TOO_LARGE = 2
+        };
+
+        static const int REQUEST_SIZE = 16;
+        static const int RESPONSE_HEADER_SIZE = 8;
+        // Default largest maze served, in cells. A maze's cache entry takes about 9 bytes per cell, and generating
+        // it about 20 more.
+        static const int DEFAULT_MAX_CELLS = 1 << 22;
+
+        /**
+         * Constructor to create a maze server
+         * @param socketPath - file system path of the Unix domain socket to listen on
+         * @param threadCount - number of worker threads serving connections
+         * @param cacheCapacity - maximum number of mazes kept in the cache, which is also limited to 1 GiB
+         * @param diskCache - optional on-disk cache consulted when a maze is not cached in memory
+         * @param maxCells - largest maze served; requests for larger mazes are answered with TOO_LARGE
+        */
+        MazeServer(std::string socketPath, int threadCount = 4, int cacheCapacity = 1024, MazeCache * diskCache = nullptr,
+                   int maxCells = DEFAULT_MAX_CELLS);
+
+        /**
+         * Destructor; stops worker threads and removes the socket
+        */
+        virtual ~MazeServer();
+
+        /**
+         * Listens on the socket and serves requests until SIGINT or SIGTERM is received. Returns false if the
+         * socket could not be created.
+        */
+        bool run();
+
+    private:
+        // Generated maze and its solution, shared read-only between requests
+        struct CacheEntry {
+            int width;
+            int height;
+            std::vector<uint8_t> paths; // Maze::getEncodedPaths()
+            std::vector<uint32_t> solution; // cells from (0,0) to the goal
+            std::vector<uint32_t> towardGoal; // for each cell, the next cell on its path to the goal
+        };
+
+        // Key is (width, height, algorithm, seed)
+        typedef std::tuple<int, int, int, uint32_t> CacheKey;
+
+        // Recent request latencies for one op, in microseconds
+        struct LatencyLog {
+            std::vector<uint32_t> samples;
+            size_t next = 0;
+            uint32_t count = 0;
+        };
+
+        std::string socketPath;
+        int listenSocket;
+        // Complete request read from a connection, waiting for a worker
+        struct Request {
+            int client;
+            uint8_t bytes[REQUEST_SIZE];
+        };
+
+        // Buffered input and output of a connection, used only by the thread in run()
+        struct Connection {
+            std::vector<uint8_t> input; // received bytes not yet queued as requests
+            std::vector<uint8_t> output; // response being sent
+            size_t outputSent = 0;
+            bool isBusy = false; // a request is queued or being answered; requests are answered one at a time
+            bool isClosing = false; // client finished sending, close once the last response is sent
+            bool isFailed = false; // close as soon as no worker is answering a request
+        };
+
+        int wakePipe[2]; // written to wake run() when a response is ready or a stop signal arrives
+        std::vector<std::thread> workers;
+        std::queue<Request> pendingRequests; // for the workers
+        std::vector<std::pair<int, std::vector<uint8_t>>> responses; // (client, response) from the workers
+        std::mutex clientsMutex;
+        std::condition_variable clientsAvailable;
+        bool stopping;
+
+        int cacheCapacity;
+        int maxCells;
+        size_t cachedBytes; // memory used by the cached entries
+        MazeCache * diskCache;
+        std::map<CacheKey, std::pair<std::shared_ptr<const CacheEntry>, std::list<CacheKey>::iterator>> cache;
+        std::list<CacheKey> recentlyUsed; // most recently used first
+        std::mutex cacheMutex;
+
+        LatencyLog latencies[STATS - 1]; // indexed by op - 1
+        std::mutex latencyMutex;
+
+        /**
+         * Worker thread; answers requests from pendingRequests, passing each response back to run(), until the 
+         * server stops
+        */
+        void serveClients();
+
+        /**
+         * Polls the listening socket and connections, accepting new connections, reading requests and queueing 
+         * them for the workers, and sending their responses, until a stop signal arrives
+        */
+        void pollClients();
+
+        /**
+         * Reads whatever input is available on a connection without blocking. Stops reading once a bounded 
+         * number of requests are buffered.
+         * @param client - connected socket
+         * @param connection - the connection's buffers
+        */
+        void readInput(int client, Connection & connection);
+
+        /**
+         * Sends as much of a connection's pending response as the socket accepts without blocking
+         * @param client - connected socket
+         * @param connection - the connection's buffers
+        */
+        void writeOutput(int client, Connection & connection);
+
+        /**
+         * Signal handler for SIGINT and SIGTERM; wakes run() so it stops serving
+         * @param signal - the signal received
+        */
+        static void handleStopSignal(int signal);
+
+        /**
+         * Builds the response to a request
+         * @param request - REQUEST_SIZE bytes
+         * @param response - filled with response header and payload
+        */
+        void handleRequest(const uint8_t * request, std::vector<uint8_t> & response);
+
+        /**
+         * Returns the cached maze for key, generating and solving it on a miss
+         * @param key - maze width, height, algorithm and seed
+        */
+        std::shared_ptr<const CacheEntry> getMaze(const CacheKey & key);
+
+        /**
+         * Returns the memory used by a cache entry's tables
+         * @param entry - the entry
+        */
+        static size_t getEntryBytes(const CacheEntry & entry);
+
+        /**
+         * Generates (or reads from the disk cache) and solves a maze
+         * @param key - maze width, height, algorithm and seed
+        */
+        std::shared_ptr<const CacheEntry> createEntry(const CacheKey & key);
+
+        /**
+         * Records the latency of a request
+         * @param op - request op
+         * @param microseconds - time taken to build the response
+        */
+        void recordLatency(int op, uint32_t microseconds);
+
+        /**
+         * Appends the STATS payload to response
+         * @param response - response to append to
+        */
+        void appendStats(std::vector<uint8_t> & response);
+
+};
+
+#endif
@@ -16,6 +16,43 @@ std::set<int> MazeSolver::getSolution() {
     return solution;
 }
 
+/**
+ * Returns, for each cell, the next cell on its path to the goal (the goal maps to itself). Computed with an
+ * iterative breadth first search from the goal, so unlike the solver it doesn't recurse once per cell.
+ * Following the table from cell 0 gives the maze solution in order.
+ * @param paths - maze passages (see Maze::getEncodedPaths)
+ * @param width - maze width
+ * @param height - maze height
+*/
+std::vector<uint32_t> MazeSolver::getStepsTowardGoal(const std::vector<uint8_t> & paths, int width, int height) {
+    int cells = width * height;
+    uint32_t goal = cells - 1;
+    std::vector<uint32_t> towardGoal(cells, goal);
+    std::vector<bool> visited(cells, false);
+    std::vector<uint32_t> queue;
+    queue.reserve(cells);
+    queue.push_back(goal);
+    visited[goal] = true;
+    for (size_t i = 0; i < queue.size(); i++) {
+        uint32_t cell = queue[i];
+        int x = cell % width;
+        int y = cell / width;
+        uint32_t neighbors[4];
+        int count = 0;
+        if (paths[cell] & 1) neighbors[count++] = cell + 1;
+        if (paths[cell] & 2) neighbors[count++] = cell + width;
+        if (x > 0 && (paths[cell - 1] & 1)) neighbors[count++] = cell - 1;
+        if (y > 0 && (paths[cell - width] & 2)) neighbors[count++] = cell - width;
+        for (int j = 0; j < count; j++) {
+            if (visited[neighbors[j]]) continue;
+            visited[neighbors[j]] = true;
+            towardGoal[neighbors[j]] = cell;
+            queue.push_back(neighbors[j]);
+        }
+    }
+    return towardGoal;
+}
+
 /**
  * Finds a solution to the maze. Cells that are part of the solution are stored in this.solution
 */
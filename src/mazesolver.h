@@ -18,6 +18,15 @@ class MazeSolver {
         */
         std::set<int> getSolution();
 
+        /**
+         * Returns, for each cell, the next cell on its path to the goal (the goal maps to itself). Computed with an
+         * iterative breadth first search from the goal, so unlike the solver it doesn't recurse once per cell.
+         * Following the table from cell 0 gives the maze solution in order.
+         * @param paths - maze passages (see Maze::getEncodedPaths)
+         * @param width - maze width
+         * @param height - maze height
+        */
+        static std::vector<uint32_t> getStepsTowardGoal(const std::vector<uint8_t> & paths, int width, int height);
 
     private:
         std::set<int> solution;
@@ -0,0 +1,133 @@
+#include "movelog.h"
+#include "binaryio.h"
+
+static const uint32_t MOVELOG_MAGIC = 0x4d4c4f47; // "MLOG"
+
+/**
+ * Constructor to create an empty move log
+ * @param startX - x coordinate the moves start from
+ * @param startY - y coordinate the moves start from
+*/
+MoveLog::MoveLog(int startX, int startY) {
+    clear(startX, startY);
+}
+
+/**
+ * Removes all moves from the log and resets the starting position
+ * @param startX - x coordinate the moves start from
+ * @param startY - y coordinate the moves start from
+*/
+void MoveLog::clear(int startX, int startY) {
+    moves.clear();
+    checkpoints.clear();
+    count = 0;
+    x = startX;
+    y = startY;
+    checkpoints.push_back(std::make_tuple(x, y));
+}
+
+/**
+ * Appends a move to the log. Moves are stored in 2 bits each. Returns false, without recording the move, if
+ * the log already holds MAX_MOVES.
+ * @param direction - direction moved
+*/
+bool MoveLog::record(Maze::Direction direction) {
+    if (count == MAX_MOVES) return false;
+    if (count % 4 == 0) moves.push_back(0);
+    moves.back() |= static_cast<uint8_t>(direction) << (2 * (count % 4));
+    count++;
+    step(direction, x, y);
+    if (count % CHECKPOINT_INTERVAL == 0) {
+        checkpoints.push_back(std::make_tuple(x, y));
+    }
+    return true;
+}
+
+/**
+ * Returns the number of moves in the log
+*/
+int MoveLog::size() const {
+    return count;
+}
+
+/**
+ * Returns a move from the log
+ * @param index - index of the move, must be < size()
+*/
+Maze::Direction MoveLog::getMove(int index) const {
+    return static_cast<Maze::Direction>((moves[index / 4] >> (2 * (index % 4))) & 3);
+}
+
+/**
+ * Returns the x and y position after the first moveCount moves. Seeks from the nearest checkpoint, 
+ * so takes at most CHECKPOINT_INTERVAL steps.
+ * @param moveCount - number of moves to apply, must be <= size()
+*/
+std::tuple<int, int> MoveLog::getPosition(int moveCount) const {
+    int checkpoint = moveCount / CHECKPOINT_INTERVAL;
+    int posX = std::get<0>(checkpoints[checkpoint]);
+    int posY = std::get<1>(checkpoints[checkpoint]);
+    for (int i = checkpoint * CHECKPOINT_INTERVAL; i < moveCount; i++) {
+        step(getMove(i), posX, posY);
+    }
+    return std::make_tuple(posX, posY);
+}
+
+/**
+ * Writes the move log to a binary stream. Returns false if the write failed.
+ * @param out - stream to write to
+*/
+bool MoveLog::save(std::ostream & out) const {
+    writeUint32(out, MOVELOG_MAGIC);
+    writeUint32(out, static_cast<uint32_t>(std::get<0>(checkpoints[0])));
+    writeUint32(out, static_cast<uint32_t>(std::get<1>(checkpoints[0])));
+    writeUint32(out, static_cast<uint32_t>(count));
+    out.write(reinterpret_cast<const char*>(moves.data()), moves.size());
+    return static_cast<bool>(out);
+}
+
+/**
+ * Reads a move log written by save, replacing the current contents. Returns false if the stream does not
+ * contain a valid move log or holds more than MAX_MOVES moves, in which case the log is left empty.
+ * @param in - stream to read from
+*/
+bool MoveLog::load(std::istream & in) {
+    uint32_t magic, startX, startY, moveCount;
+    clear();
+    if (!readUint32(in, magic) || magic != MOVELOG_MAGIC || !readUint32(in, startX) || 
+        !readUint32(in, startY) || !readUint32(in, moveCount) || moveCount > static_cast<uint32_t>(MAX_MOVES)) {
+        return false;
+    }
+    std::vector<uint8_t> packed((moveCount + 3) / 4);
+    if (!in.read(reinterpret_cast<char*>(packed.data()), packed.size())) return false;
+
+    // re-record moves so checkpoints are rebuilt
+    clear(static_cast<int>(startX), static_cast<int>(startY));
+    for (uint32_t i = 0; i < moveCount; i++) {
+        record(static_cast<Maze::Direction>((packed[i / 4] >> (2 * (i % 4))) & 3));
+    }
+    return true;
+}
+
+/**
+ * Moves the x and y coordinates one cell in direction
+ * @param direction - direction to move
+ * @param x - x coordinate to update
+ * @param y - y coordinate to update
+*/
+void MoveLog::step(Maze::Direction direction, int & x, int & y) {
+    switch (direction) {
+        case Maze::Up:
+            y--;
+            break;
+        case Maze::Down:
+            y++;
+            break;
+        case Maze::Left:
+            x--;
+            break;
+        case Maze::Right:
+            x++;
+            break;
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef MOVELOG_H_
+#define MOVELOG_H_
+
+#include <iostream>
+#include <vector>
+#include <tuple>
+#include <stdint.h>
+
+#include "maze.h"
+
+class MoveLog { 
+    public:
+        // Number of moves between stored position checkpoints
+        static const int CHECKPOINT_INTERVAL = 256;
+        // Largest number of moves a log holds (64 MiB of packed moves)
+        static const int MAX_MOVES = 1 << 28;
+
+        /**
+         * Constructor to create an empty move log
+         * @param startX - x coordinate the moves start from
+         * @param startY - y coordinate the moves start from
+        */
+        MoveLog(int startX = 0, int startY = 0);
+
+        /**
+         * Removes all moves from the log and resets the starting position
+         * @param startX - x coordinate the moves start from
+         * @param startY - y coordinate the moves start from
+        */
+        void clear(int startX = 0, int startY = 0);
+
+        /**
+         * Appends a move to the log. Moves are stored in 2 bits each. Returns false, without recording the move, if
+         * the log already holds MAX_MOVES.
+         * @param direction - direction moved
+        */
+        bool record(Maze::Direction direction);
+
+        /**
+         * Returns the number of moves in the log
+        */
+        int size() const;
+
+        /**
+         * Returns a move from the log
+         * @param index - index of the move, must be < size()
+        */
+        Maze::Direction getMove(int index) const;
+
+        /**
+         * Returns the x and y position after the first moveCount moves. Seeks from the nearest checkpoint, 
+         * so takes at most CHECKPOINT_INTERVAL steps.
+         * @param moveCount - number of moves to apply, must be <= size()
+        */
+        std::tuple<int, int> getPosition(int moveCount) const;
+
+        /**
+         * Writes the move log to a binary stream. Returns false if the write failed.
+         * @param out - stream to write to
+        */
+        bool save(std::ostream & out) const;
+
+        /**
+         * Reads a move log written by save, replacing the current contents. Returns false if the stream does not
+         * contain a valid move log or holds more than MAX_MOVES moves, in which case the log is left empty.
+         * @param in - stream to read from
+        */
+        bool load(std::istream & in);
+
+        /**
+         * Moves the x and y coordinates one cell in direction
+         * @param direction - direction to move
+         * @param x - x coordinate to update
+         * @param y - y coordinate to update
+        */
+        static void step(Maze::Direction direction, int & x, int & y);
+
+    private:
+        std::vector<uint8_t> moves; // 4 moves per byte, first move in the low bits
+        int count;
+        int x; // position after the last recorded move
+        int y;
+        std::vector<std::tuple<int, int>> checkpoints; // position after every CHECKPOINT_INTERVAL moves
+
+};
+
+#endif
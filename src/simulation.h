@@ -0,0 +1,118 @@
+#ifndef SIMULATION_H_
+#define SIMULATION_H_
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdint.h>
+
+#include "maze.h"
+
+/**
+ * Estimates maze difficulty by moving many simulated players (agents) from the top left cell to the goal.
+ * The maze is copied once into a read-only array of open directions per cell that all threads share. Agent
+ * state is stored as structure-of-arrays and agents are stepped together in fixed size batches, sharded across
+ * threads.
+*/
+class Simulation { 
+    public:
+        // How agents choose their next move
+        enum Policy {
+            RandomWalk,   // move through a random open passage
+            WallFollower, // keep the right hand on the wall, starting in a random direction
+            Tremaux       // Tremaux's algorithm, marking passages each time they're walked
+        };
+
+        // Results of a simulation run
+        struct Results {
+            long agents = 0;
+            long solved = 0; // agents that reached the goal within maxSteps
+            uint64_t agentSteps = 0; // total steps taken by all agents
+            double seconds = 0;
+            std::vector<uint32_t> stepsToGoal; // sorted, one entry per solved agent
+            std::vector<uint64_t> cellVisits; // number of times agents entered each cell (getCellInteger order)
+        };
+
+        /**
+         * Constructor to create a simulation over a maze
+         * @param maze - the maze; it is copied, so may be changed or destroyed afterwards
+        */
+        Simulation(Maze & maze);
+
+        /**
+         * Runs agents from (0,0) until they reach the goal or take maxSteps steps
+         * @param policy - how agents move
+         * @param agents - number of agents
+         * @param maxSteps - steps after which an agent gives up
+         * @param threads - number of threads to shard agents across
+         * @param seed - seed for the agents' random choices
+        */
+        Results run(Policy policy, long agents, uint32_t maxSteps, int threads, uint32_t seed);
+
+        /**
+         * Prints the steps-to-goal distribution, throughput and most visited cells
+         * @param results - results of run
+         * @param heatmap - also print the maze with cells shaded by visits per agent
+        */
+        void printResults(const Results & results, bool heatmap);
+
+    private:
+        int width;
+        int height;
+        int goal;
+        std::vector<uint8_t> openDirections; // per cell, bit (1 << Maze::Direction) set if there is a passage
+        int offsets[4]; // change in cell number for a move in each Maze::Direction
+        uint8_t openCount[16]; // number of open directions for each openDirections value
+        uint8_t openList[16][4]; // the open directions for each openDirections value
+        uint8_t rightHandTurn[16][4]; // next heading for a wall follower, by openDirections value and heading
+
+        /**
+         * Runs one thread's share of agents
+         * @param policy - how agents move
+         * @param firstAgent - index of the thread's first agent, used to seed agents
+         * @param agents - number of agents
+         * @param maxSteps - steps after which an agent gives up
+         * @param seed - simulation seed
+         * @param results - filled with the thread's results (stepsToGoal unsorted)
+        */
+        void runShard(Policy policy, long firstAgent, long agents, uint32_t maxSteps, uint32_t seed, Results & results);
+
+        /**
+         * Steps a batch of random walk or wall follower agents until all reach the goal or maxSteps
+         * @param policy - RandomWalk or WallFollower
+         * @param count - number of agents in the batch
+         * @param position - cell of each agent
+         * @param heading - direction each agent last moved
+         * @param rng - xorshift state of each agent
+         * @param steps - steps taken by each agent
+         * @param maxSteps - steps after which an agent gives up
+         * @param cellVisits - incremented for every cell entered
+        */
+        void stepBatch(Policy policy, int count, int32_t * position, uint8_t * heading, uint32_t * rng, 
+                       uint32_t * steps, uint32_t maxSteps, uint64_t * cellVisits);
+
+        /**
+         * Runs one Tremaux agent to the goal or maxSteps. Returns true if the agent reached the goal.
+         * @param rng - agent's xorshift state
+         * @param marks - 2 bits per passage, cleared; indexed by cell * 2 (right passage) and cell * 2 + 1 (down)
+         * @param maxSteps - steps after which the agent gives up
+         * @param cellVisits - incremented for every cell entered
+         * @param steps - set to the number of steps taken
+        */
+        bool runTremaux(uint32_t & rng, std::vector<uint8_t> & marks, uint32_t maxSteps, uint64_t * cellVisits,
+                        uint32_t & steps);
+
+        /**
+         * Returns the passage index (see runTremaux) between a cell and its neighbor in direction
+         * @param cell - cell number
+         * @param direction - direction of the passage
+        */
+        int getPassage(int cell, int direction);
+
+};
+
+#endif
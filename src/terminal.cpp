@@ -0,0 +1,107 @@
+#include "terminal.h"
+
+static const int HANDLED_SIGNALS[] = { SIGINT, SIGTERM, SIGHUP, SIGQUIT, SIGTSTP };
+
+struct termios RawTerminal::originalState;
+bool RawTerminal::isRaw = false;
+
+/**
+ * Constructor; switches the terminal to raw, non-blocking input (no line buffering or echo) and hides the 
+ * cursor. The original terminal state is restored by the destructor, on exit, and on fatal signals.
+*/
+RawTerminal::RawTerminal()
+    : endOfInput(false)
+{
+    static bool exitHandlerInstalled = false;
+    if (!exitHandlerInstalled) {
+        atexit(restore);
+        exitHandlerInstalled = true;
+    }
+    if (tcgetattr(STDIN_FILENO, &originalState) != 0) return; // not a terminal, reads still work unbuffered
+    for (int signal : HANDLED_SIGNALS) {
+        ::signal(signal, handleSignal);
+    }
+    enable();
+}
+
+/**
+ * Destructor; restores the original terminal state
+*/
+RawTerminal::~RawTerminal() {
+    restore();
+    for (int signal : HANDLED_SIGNALS) {
+        ::signal(signal, SIG_DFL);
+    }
+}
+
+/**
+ * Returns all keys pressed since the last call, in order, without blocking. Returns an empty string if 
+ * no input is pending.
+*/
+std::string RawTerminal::readKeys() {
+    std::string keys;
+    char buffer[64];
+    struct pollfd input = { STDIN_FILENO, POLLIN, 0 };
+    // poll first so reads never block, even when stdin is not a terminal
+    while (!endOfInput && poll(&input, 1, 0) > 0) {
+        ssize_t bytesRead = read(STDIN_FILENO, buffer, sizeof(buffer));
+        if (bytesRead <= 0) {
+            endOfInput = bytesRead == 0;
+            break;
+        }
+        keys.append(buffer, bytesRead);
+    }
+    return keys;
+}
+
+/**
+ * Returns true if input has been closed (end of file reached on a non-terminal stdin)
+*/
+bool RawTerminal::isClosed() {
+    return endOfInput;
+}
+
+/**
+ * Applies raw mode to the terminal
+*/
+void RawTerminal::enable() {
+    struct termios raw = originalState;
+    raw.c_lflag &= ~(ICANON | ECHO);
+    raw.c_iflag &= ~(IXON | ICRNL);
+    raw.c_cc[VMIN] = 0; // read returns immediately, even if no input is pending
+    raw.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) != 0) return;
+    isRaw = true;
+    const char hideCursor[] = "\033[?25l";
+    write(STDOUT_FILENO, hideCursor, sizeof(hideCursor) - 1);
+}
+
+/**
+ * Restores the original terminal state and shows the cursor. Safe to call from a signal handler.
+*/
+void RawTerminal::restore() {
+    if (!isRaw) return;
+    tcsetattr(STDIN_FILENO, TCSANOW, &originalState);
+    isRaw = false;
+    const char showCursor[] = "\033[?25h";
+    write(STDOUT_FILENO, showCursor, sizeof(showCursor) - 1);
+}
+
+/**
+ * Restores the terminal then re-raises the signal with its default action. Re-enables raw mode if the 
+ * process is continued after being stopped.
+ * @param signal - the signal received
+*/
+void RawTerminal::handleSignal(int signal) {
+    restore();
+    ::signal(signal, SIG_DFL);
+    // the signal is blocked while its handler runs, unblock it so the default action happens now
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, signal);
+    sigprocmask(SIG_UNBLOCK, &mask, nullptr);
+    raise(signal);
+    // only reached if the process was stopped (SIGTSTP) and then continued
+    ::signal(signal, handleSignal);
+    enable();
+}
@@ -0,0 +1,59 @@
+#ifndef TERMINAL_H_
+#define TERMINAL_H_
+
+#include <string>
+#include <termios.h>
+#include <unistd.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <poll.h>
+
+class RawTerminal { 
+    public:
+        /**
+         * Constructor; switches the terminal to raw, non-blocking input (no line buffering or echo) and hides the 
+         * cursor. The original terminal state is restored by the destructor, on exit, and on fatal signals.
+        */
+        RawTerminal();
+
+        /**
+         * Destructor; restores the original terminal state
+        */
+        virtual ~RawTerminal();
+
+        /**
+         * Returns all keys pressed since the last call, in order, without blocking. Returns an empty string if 
+         * no input is pending.
+        */
+        std::string readKeys();
+
+        /**
+         * Returns true if input has been closed (end of file reached on a non-terminal stdin)
+        */
+        bool isClosed();
+
+    private:
+        bool endOfInput;
+        static struct termios originalState;
+        static bool isRaw;
+
+        /**
+         * Applies raw mode to the terminal
+        */
+        static void enable();
+
+        /**
+         * Restores the original terminal state and shows the cursor. Safe to call from a signal handler.
+        */
+        static void restore();
+
+        /**
+         * Restores the terminal then re-raises the signal with its default action. Re-enables raw mode if the 
+         * process is continued after being stopped.
+         * @param signal - the signal received
+        */
+        static void handleSignal(int signal);
+
+};
+
+#endif